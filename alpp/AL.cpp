@@ -3,15 +3,22 @@
 #define AL_ALEXT_PROTOTYPES
 
 #include "AL.hpp"
+#include "AL.inl"
+#include "Stats.hpp"
 
 #include <AL/al.h>
 #include <AL/alc.h>
 #include <AL/alext.h>
 #include <AL/efx.h>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include <utility>
 #include <stdexcept>
 #include <cassert>
+#include <cstring>
 #include <string>
 
 #ifndef ALPP_DECL
@@ -22,19 +29,46 @@
 	#endif
 #endif
 
+// Same as in AL.inl, which #undefs its copies
 #ifndef NDEBUG
 	#define AL_ERROR_CHECKING
 #endif
 
+#ifdef ALPP_COUNT_CALLS
+#define AL_COUNT_CALL() al::Stats::global().alCalls.add()
+#else
+#define AL_COUNT_CALL() ((void)0)
+#endif
+
+namespace al::detail {
+// Members of the views see their template parameter instead, everything else here checks like DefaultChecking views
+using CheckPolicy = DefaultChecking;
+}
+namespace al { using detail::CheckPolicy; }
+
+#define AL_CHECK_ERROR() (AL_COUNT_CALL(), al::detail::ChecksErrors<CheckPolicy> && !al::detail::DebugOutputActive() ? al::detail::CheckError(__FILE__, __LINE__) : (void)0)
+
+#ifdef ALPP_STATS
+#define AL_STAT(name, op, value) al::Stats::global().name.op(value, std::memory_order_relaxed)
+#else
+#define AL_STAT(name, op, value) ((void)0)
+#endif
+
+namespace al::detail { ALPP_DECL void ReportError(int error, const char* message, const char* file, int line) noexcept; }
+
+#ifdef ALPP_NO_EXCEPTIONS
+	#define ERRCASE(X, MSG) case X: al::detail::ReportError(err, #X ": " MSG, file, line); break
+#else
+	#define ERRCASE(X, MSG) case X: throw std::runtime_error(#X ": " MSG " at " + std::string(file) + ":" + std::to_string(line))
+#endif
+
 #ifdef AL_ERROR_CHECKING
 #define AL_HANDLE_CHECK(X) assert(X)
-#define AL_CHECK_ERROR() alCheckError(__FILE__, __LINE__)
 #define ALC_CHECK_ERROR(device) alcCheckError(device, __FILE__, __LINE__)
 static
 void alcCheckError(ALCdevice* device, const char* file, int line) {
 	int err = alcGetError(device);
 	if(err != ALC_NO_ERROR) {
-		#define ERRCASE(X, MSG) case X: throw std::runtime_error(#X ": " MSG " at " + std::string(file) + ":" + std::to_string(line))
 		switch (err) {
 			ERRCASE(ALC_NO_ERROR, "there is not currently an error");
 			ERRCASE(ALC_INVALID_DEVICE, "a bad device was passed to an OpenAL function");
@@ -43,14 +77,17 @@ void alcCheckError(ALCdevice* device, const char* file, int line) {
 			ERRCASE(ALC_INVALID_VALUE, "an invalid value was passed to an OpenAL function");
 			ERRCASE(ALC_OUT_OF_MEMORY, "the requested operation resulted in OpenAL running out of memory");
 		}
-		#undef ERRCASE
 	}
 }
-static
-void alCheckError(const char* file, int line) {
+#else
+#define AL_HANDLE_CHECK(X)
+#define ALC_CHECK_ERROR(device)
+#endif
+
+// Always available, Checked views use it even with NDEBUG
+ALPP_DECL void al::detail::CheckError(const char* file, int line) {
 	int err = alGetError();
 	if(err != AL_NO_ERROR) {
-		#define ERRCASE(X, MSG) case X: throw std::runtime_error(#X ": " MSG " at " + std::string(file) + ":" + std::to_string(line))
 		switch (err) {
 			ERRCASE(AL_NO_ERROR, "there is not currently an error");
 			ERRCASE(AL_INVALID_NAME, "a bad name (ID) was passed to an OpenAL function");
@@ -59,30 +96,158 @@ void alCheckError(const char* file, int line) {
 			ERRCASE(AL_INVALID_OPERATION, "the requested operation is not valid");
 			ERRCASE(AL_OUT_OF_MEMORY, "allocation failed");
 		}
-		#undef ERRCASE
 	}
 }
-#else
-#define AL_HANDLE_CHECK(X)
-#define AL_CHECK_ERROR()
-#define ALC_CHECK_ERROR(device)
-#endif
+#undef ERRCASE
 
 namespace al {
 
+namespace detail {
+
+ALPP_DECL std::atomic<ErrorHandler>& CurrentErrorHandler() noexcept {
+	static std::atomic<ErrorHandler> handler = nullptr;
+	return handler;
+}
+ALPP_DECL int& LastErrorStorage() noexcept {
+	static thread_local int error = 0;
+	return error;
+}
+ALPP_DECL void ReportError(int error, const char* message, const char* file, int line) noexcept {
+	LastErrorStorage() = error;
+	if(ErrorHandler handler = CurrentErrorHandler().load(std::memory_order_relaxed))
+		handler(error, message, file, line);
+}
+
+// Devices opened by Device::OpenLoopback, a DeviceView only has the handle
+ALPP_DECL std::vector<void*>& LoopbackDevices() noexcept {
+	static std::vector<void*> devices;
+	return devices;
+}
+ALPP_DECL std::mutex& LoopbackDevicesMutex() noexcept {
+	static std::mutex mutex;
+	return mutex;
+}
+ALPP_DECL void CloseDevice(void* device) noexcept {
+	{
+		std::lock_guard<std::mutex> lock(LoopbackDevicesMutex());
+		auto& devices = LoopbackDevices();
+		devices.erase(std::remove(devices.begin(), devices.end(), device), devices.end());
+	}
+	alcCloseDevice((ALCdevice*)device);
+}
+
+// Debug contexts report errors through the callback, calls made while one of them is current don't need to ask alGetError.
+// Fixed slots so the check never locks, a debug context that finds them all taken keeps polling alGetError.
+constexpr size_t MaxDebugContexts = 8;
+
+ALPP_DECL std::atomic<void*>* DebugContexts() noexcept {
+	static std::atomic<void*> contexts[MaxDebugContexts] = {};
+	return contexts;
+}
+ALPP_DECL std::atomic<int>& DebugContextCount() noexcept {
+	static std::atomic<int> count = 0;
+	return count;
+}
+ALPP_DECL bool DebugOutputActive() noexcept {
+	if(DebugContextCount().load(std::memory_order_relaxed) == 0) return false; // No alcGetCurrentContext unless there is a debug context
+	void* current = alcGetCurrentContext();
+	if(!current) return false;
+	for(size_t i = 0; i < MaxDebugContexts; i++)
+		if(DebugContexts()[i].load(std::memory_order_relaxed) == current) return true;
+	return false;
+}
+ALPP_DECL void AddDebugContext(void* context) noexcept {
+	for(size_t i = 0; i < MaxDebugContexts; i++) {
+		void* expected = nullptr;
+		if(DebugContexts()[i].compare_exchange_strong(expected, context, std::memory_order_relaxed)) {
+			DebugContextCount().fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+}
+ALPP_DECL void RemoveDebugContext(void* context) noexcept {
+	for(size_t i = 0; i < MaxDebugContexts; i++) {
+		void* expected = context;
+		if(DebugContexts()[i].compare_exchange_strong(expected, nullptr, std::memory_order_relaxed)) {
+			DebugContextCount().fetch_sub(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+}
+
+ALPP_DECL void AL_APIENTRY DebugCallback(ALenum source, ALenum type, ALuint id, ALenum severity, ALsizei length, const ALchar* message, void* userParam) noexcept {
+	DebugLog& log = *static_cast<DebugLog*>(userParam);
+	if(severity > (ALenum)log.minSeverity()) return;
+
+	DebugMessage m;
+	m.source   = (DebugSource)source;
+	m.type     = (DebugType)type;
+	m.severity = (DebugSeverity)severity;
+	m.id       = id;
+	size_t n = length < 0 ? strlen(message) : (size_t)length;
+	if(n >= sizeof(m.text)) n = sizeof(m.text) - 1;
+	memcpy(m.text, message, n);
+	m.text[n] = '\0';
+
+	log.push(m);
+}
+
+} // namespace detail
+
+ALPP_DECL void SetErrorHandler(ErrorHandler handler) noexcept { detail::CurrentErrorHandler().store(handler, std::memory_order_relaxed); }
+ALPP_DECL int  LastError() noexcept { return std::exchange(detail::LastErrorStorage(), 0); }
+
+ALPP_DECL unsigned long long CallCount() noexcept { return Stats::global().alCalls.load(); }
+
+namespace detail {
+ALPP_DECL std::atomic<uint64_t>& PlayCounter() noexcept {
+	static std::atomic<uint64_t> count = 0;
+	return count;
+}
+ALPP_DECL std::atomic<int64_t>& PlayerSoundCounter() noexcept {
+	static std::atomic<int64_t> count = 0;
+	return count;
+}
+} // namespace detail
+
+ALPP_DECL unsigned long long PlayCount() noexcept               { return detail::PlayCounter().load(std::memory_order_relaxed); }
+ALPP_DECL long long          PlayerSounds() noexcept            { return detail::PlayerSoundCounter().load(std::memory_order_relaxed); }
+ALPP_DECL void               AddPlayerSounds(long long delta) noexcept { detail::PlayerSoundCounter().fetch_add(delta, std::memory_order_relaxed); }
+
 ALPP_DECL int DeviceView::geti(int param) const noexcept {
 	int result;
 	alcGetIntegerv((ALCdevice*) mDeviceHandle, param, 1, &result);
 	return result;
 }
 ALPP_DECL const char* DeviceView::gets(int param) const noexcept { return alcGetString((ALCdevice*) mDeviceHandle, param); }
+ALPP_DECL int DeviceView::frequency() const noexcept { return geti(ALC_FREQUENCY); }
+ALPP_DECL int DeviceView::sends()     const noexcept { return geti(ALC_MAX_AUXILIARY_SENDS); }
+ALPP_DECL int64_t DeviceView::latency() const noexcept {
+	ALCint64SOFT result = 0;
+	alcGetInteger64vSOFT((ALCdevice*) mDeviceHandle, ALC_DEVICE_LATENCY_SOFT, 1, &result);
+	return result;
+}
 ALPP_DECL const char* DeviceView::getStringISOFT(int paramName, size_t index) const noexcept { return alcGetStringiSOFT((ALCdevice*) mDeviceHandle, paramName, index); }
+ALPP_DECL bool DeviceView::isRenderFormatSupported(int frequency, int channels, int type) const noexcept {
+	return alcIsRenderFormatSupportedSOFT((ALCdevice*) mDeviceHandle, frequency, channels, type);
+}
+ALPP_DECL void DeviceView::renderSamples(void* buffer, int frames) const noexcept {
+	alcRenderSamplesSOFT((ALCdevice*) mDeviceHandle, buffer, frames);
+}
+ALPP_DECL bool DeviceView::loopback() const noexcept {
+	std::lock_guard<std::mutex> lock(detail::LoopbackDevicesMutex());
+	auto& devices = detail::LoopbackDevices();
+	return std::find(devices.begin(), devices.end(), mDeviceHandle) != devices.end();
+}
+// OpenAL Soft lists the extension for loopback devices too, but pausing them is an ALC_INVALID_DEVICE
+ALPP_DECL bool DeviceView::canPause() const noexcept { return !loopback() && alcIsExtensionPresent((ALCdevice*) mDeviceHandle, "ALC_SOFT_pause_device"); }
+ALPP_DECL void DeviceView::pause()  const noexcept { alcDevicePauseSOFT((ALCdevice*) mDeviceHandle);  ALC_CHECK_ERROR((ALCdevice*) mDeviceHandle); }
+ALPP_DECL void DeviceView::resume() const noexcept { alcDeviceResumeSOFT((ALCdevice*) mDeviceHandle); ALC_CHECK_ERROR((ALCdevice*) mDeviceHandle); }
 
 // =============================================================
 // == Device =============================================
 // =============================================================
 
-
 ALPP_DECL Device::Device(std::nullptr_t) noexcept :
 	DeviceView(nullptr)
 {}
@@ -91,22 +256,96 @@ ALPP_DECL Device::Device(const char* name) noexcept :
 {
 	mDeviceHandle = alcOpenDevice(name);
 }
+ALPP_DECL Device Device::OpenLoopback(const char* name) noexcept {
+	Device result = nullptr;
+	result.mDeviceHandle = alcLoopbackOpenDeviceSOFT(name);
+	if(result.mDeviceHandle) {
+		std::lock_guard<std::mutex> lock(detail::LoopbackDevicesMutex());
+		detail::LoopbackDevices().push_back(result.mDeviceHandle);
+	}
+	return result;
+}
 ALPP_DECL Device::Device(Device&& other) noexcept :
 	DeviceView(other.release())
 {}
 ALPP_DECL Device& Device::operator=(Device&& other) noexcept {
 	if(mDeviceHandle) {
-		alcCloseDevice((ALCdevice*)mDeviceHandle);
+		detail::CloseDevice(mDeviceHandle);
 	}
 	mDeviceHandle = other.release();
 	return *this;
 }
 ALPP_DECL Device::~Device() noexcept {
 	if(mDeviceHandle) {
-		alcCloseDevice((ALCdevice*)mDeviceHandle);
+		detail::CloseDevice(mDeviceHandle);
 	}
 }
 
+// =============================================================
+// == DebugLog =============================================
+// =============================================================
+
+ALPP_DECL DebugLog::DebugLog() noexcept {
+	for(size_t i = 0; i < Capacity; i++)
+		mCells[i].sequence.store(i, std::memory_order_relaxed);
+}
+ALPP_DECL DebugLog& DebugLog::global() noexcept {
+	static DebugLog log;
+	return log;
+}
+
+// Bounded multi producer/multi consumer queue, each cell's sequence says whether it's free for the push or ready for the pop at that position
+ALPP_DECL bool DebugLog::push(DebugMessage const& message) noexcept {
+	size_t pos = mHead.load(std::memory_order_relaxed);
+	Cell*  cell;
+	while(true) {
+		cell = &mCells[pos % Capacity];
+		size_t   seq  = cell->sequence.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+		if(diff == 0) {
+			if(mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		}
+		else if(diff < 0) {
+			mDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else {
+			pos = mHead.load(std::memory_order_relaxed);
+		}
+	}
+	cell->message = message;
+	AL_STAT(eventQueueDepth, fetch_add, 1); // Before publishing, so the pop of this message can't decrement first
+	cell->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+ALPP_DECL bool DebugLog::pop(DebugMessage& message) noexcept {
+	size_t pos = mTail.load(std::memory_order_relaxed);
+	Cell*  cell;
+	while(true) {
+		cell = &mCells[pos % Capacity];
+		size_t   seq  = cell->sequence.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+		if(diff == 0) {
+			if(mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		}
+		else if(diff < 0) {
+			return false;
+		}
+		else {
+			pos = mTail.load(std::memory_order_relaxed);
+		}
+	}
+	message = cell->message;
+	cell->sequence.store(pos + Capacity, std::memory_order_release);
+	AL_STAT(eventQueueDepth, fetch_sub, 1);
+	return true;
+}
+ALPP_DECL size_t DebugLog::size() const noexcept {
+	size_t head = mHead.load(std::memory_order_relaxed);
+	size_t tail = mTail.load(std::memory_order_relaxed);
+	return head > tail ? head - tail : 0;
+}
+
 // =============================================================
 // == Context =============================================
 // =============================================================
@@ -129,29 +368,75 @@ ALPP_DECL void Context::init(Options options) noexcept {
 	if(!device) {
 		device = alcOpenDevice(NULL); ALC_CHECK_ERROR(device);
 	}
+	bool debug = options.debug && options.add({ ALC_CONTEXT_FLAGS_EXT, ALC_CONTEXT_DEBUG_BIT_EXT });
+	if(options.debug && !debug) { // Without the flag the driver wouldn't report anything through the callback, leave checking to alGetError
+		DebugMessage m;
+		m.source   = DebugSource::ThirdParty;
+		m.type     = DebugType::Error;
+		m.severity = DebugSeverity::High;
+		m.id       = 0;
+		strcpy(m.text, "Context attributes full, debug context not requested");
+		DebugLog::global().push(m);
+	}
 	mContext = alcCreateContext(device, options.get()); ALC_CHECK_ERROR(device);
 	alcMakeContextCurrent((ALCcontext*)mContext); ALC_CHECK_ERROR(device);
 	alGetError(); // Clear errors
+
+	if(debug && mContext && alIsExtensionPresent("AL_EXT_debug")) {
+		DebugLog& log = DebugLog::global();
+		alDebugMessageCallbackEXT(&detail::DebugCallback, &log);
+		for(ALenum severity : { AL_DEBUG_SEVERITY_HIGH_EXT, AL_DEBUG_SEVERITY_MEDIUM_EXT, AL_DEBUG_SEVERITY_LOW_EXT, AL_DEBUG_SEVERITY_NOTIFICATION_EXT }) {
+			ALboolean enable = severity <= (ALenum)log.minSeverity() ? AL_TRUE : AL_FALSE;
+			alDebugMessageControlEXT(AL_DONT_CARE_EXT, AL_DONT_CARE_EXT, severity, 0, nullptr, enable);
+		}
+		detail::AddDebugContext(mContext);
+	}
 }
 ALPP_DECL void Context::close() noexcept {
 	if(mContext == nullptr)
 		return;
 
+	// The callback goes away with the context. Resetting it here would hit whichever context is current, maybe another debug context.
+	detail::RemoveDebugContext(mContext);
+
 	auto device = alcGetContextsDevice((ALCcontext*)mContext); ALC_CHECK_ERROR(device);
 	alcMakeContextCurrent(NULL); ALC_CHECK_ERROR(device);
 	alcDestroyContext((ALCcontext*)mContext); ALC_CHECK_ERROR(device);
-	alcCloseDevice(device);
+	detail::CloseDevice(device);
+	mContext = nullptr;
 }
 ALPP_DECL DeviceView Context::device() const noexcept {
 	return { alcGetContextsDevice((ALCcontext*)mContext) };
 }
 
-
 // =============================================================
 // == Format =============================================
 // =============================================================
 
-ALPP_DECL Format MultiChannelFormat(Format mono, unsigned channels) {
+namespace detail {
+
+class FormatErrorCategory : public std::error_category {
+public:
+	const char* name() const noexcept override { return "al::Format"; }
+	std::string message(int e) const override {
+		switch((FormatError)e) {
+		case FormatError::NotMono:             return "Argument mono is not a mono format";
+		case FormatError::UnsupportedChannels: return "Unsupported number of channels";
+		case FormatError::UnknownFormat:       return "Unknown format";
+		}
+		return "Unknown error";
+	}
+};
+
+} // namespace detail
+
+ALPP_DECL std::error_category const& FormatCategory() noexcept {
+	static detail::FormatErrorCategory category;
+	return category;
+}
+
+ALPP_DECL Format MultiChannelFormat(Format mono, unsigned channels, std::error_code& error) noexcept {
+	error.clear();
 	if(channels == 1) return mono;
 
 	if(channels == 2) {
@@ -159,14 +444,16 @@ ALPP_DECL Format MultiChannelFormat(Format mono, unsigned channels) {
 			case Format::Mono8: return Format::Stereo8;
 			case Format::Mono16: return Format::Stereo16;
 			case Format::MonoF32: return Format::StereoF32;
-			default: throw std::runtime_error("Argument mono is not a mono format!");
+			default: error = FormatError::NotMono; return mono;
 		}
 	}
 
-	throw std::runtime_error("Unsupported number of channels: " + std::to_string(channels));
+	error = FormatError::UnsupportedChannels;
+	return mono;
 }
 
-ALPP_DECL void DecomposeFormat(Format fmt, Format* mono, unsigned* channels) {
+ALPP_DECL void DecomposeFormat(Format fmt, Format* mono, unsigned* channels, std::error_code& error) noexcept {
+	error.clear();
 	switch(fmt) {
 	case Format::Mono8:     if(mono) *mono = Format::Mono8;   if(channels) *channels = 1; break;
 	case Format::Mono16:    if(mono) *mono = Format::Mono16;  if(channels) *channels = 1; break;
@@ -174,32 +461,93 @@ ALPP_DECL void DecomposeFormat(Format fmt, Format* mono, unsigned* channels) {
 	case Format::Stereo8:   if(mono) *mono = Format::Mono8;   if(channels) *channels = 2; break;
 	case Format::Stereo16:  if(mono) *mono = Format::Mono16;  if(channels) *channels = 2; break;
 	case Format::StereoF32: if(mono) *mono = Format::MonoF32; if(channels) *channels = 2; break;
-	default: throw std::runtime_error("Unknown format");
+	default: error = FormatError::UnknownFormat; break;
+	}
+}
+
+ALPP_DECL Format MultiChannelFormat(Format mono, unsigned channels) {
+	std::error_code error;
+	Format result = MultiChannelFormat(mono, channels, error);
+#ifdef ALPP_NO_EXCEPTIONS
+	if(error) detail::ReportError(error.value(), "MultiChannelFormat: invalid arguments", __FILE__, __LINE__);
+#else
+	if(error == FormatError::UnsupportedChannels) throw std::runtime_error("Unsupported number of channels: " + std::to_string(channels));
+	if(error) throw std::runtime_error(error.message());
+#endif
+	return result;
+}
+
+ALPP_DECL void DecomposeFormat(Format fmt, Format* mono, unsigned* channels) {
+	std::error_code error;
+	DecomposeFormat(fmt, mono, channels, error);
+#ifdef ALPP_NO_EXCEPTIONS
+	if(error) detail::ReportError(error.value(), "DecomposeFormat: unknown format", __FILE__, __LINE__);
+#else
+	if(error) throw std::runtime_error(error.message());
+#endif
+}
+
+ALPP_DECL unsigned FrameSize(Format fmt) noexcept {
+	switch(fmt) {
+	case Format::Mono8:     return 1;
+	case Format::Mono16:    return 2;
+	case Format::MonoF32:   return 4;
+	case Format::Stereo8:   return 2;
+	case Format::Stereo16:  return 4;
+	case Format::StereoF32: return 8;
+	default: return 0;
 	}
 }
 
+ALPP_DECL bool ExtensionPresent(const char* name) noexcept {
+	return alIsExtensionPresent(name);
+}
+ALPP_DECL DeviceView CurrentDevice() noexcept {
+	ALCcontext* context = alcGetCurrentContext();
+	return { context ? alcGetContextsDevice(context) : nullptr };
+}
+
 // =============================================================
-// == BufferView =============================================
+// == Resamplers =============================================
 // =============================================================
 
-ALPP_DECL BufferView::BufferView(unsigned handle) noexcept : mHandle(handle) {}
-ALPP_DECL BufferView::~BufferView() noexcept {}
+ALPP_DECL int         ResamplerCount()                 noexcept { int result = alGetInteger(AL_NUM_RESAMPLERS_SOFT); AL_CHECK_ERROR(); return result; }
+ALPP_DECL int         DefaultResampler()               noexcept { int result = alGetInteger(AL_DEFAULT_RESAMPLER_SOFT); AL_CHECK_ERROR(); return result; }
+ALPP_DECL const char* ResamplerName(int resampler)     noexcept { const char* result = alGetStringiSOFT(AL_RESAMPLER_NAME_SOFT, resampler); AL_CHECK_ERROR(); return result; }
+ALPP_DECL int         FindResampler(const char* name)  noexcept {
+	int count = ResamplerCount();
+	for(int i = 0; i < count; i++) {
+		const char* n = ResamplerName(i);
+		if(n && strcmp(n, name) == 0) return i;
+	}
+	return -1;
+}
 
-ALPP_DECL void BufferView::data(void const* data, size_t size, Format fmt, unsigned freq) noexcept {
+// =============================================================
+// == BufferView =============================================
+// =============================================================
+
+template<class CheckPolicy> ALPP_DECL void BasicBufferView<CheckPolicy>::data(void const* data, size_t size, Format fmt, unsigned freq) noexcept {
 	alBufferData(mHandle, (ALenum)fmt, data, size, freq); AL_CHECK_ERROR();
+	AL_STAT(uploadedBytes, fetch_add, size);
 }
 
-ALPP_DECL int BufferView::geti(unsigned param) const noexcept {
-	int result;
-	alGetBufferi(mHandle, param, &result); AL_CHECK_ERROR();
-	return result;
-}
+template<class CheckPolicy> ALPP_DECL void BasicBufferView<CheckPolicy>::label(const char* name) noexcept { alObjectLabelEXT(AL_BUFFER_EXT, mHandle, -1, name); AL_CHECK_ERROR(); }
 
-ALPP_DECL int BufferView::frequency() const noexcept { return geti(AL_FREQUENCY); }
-ALPP_DECL int BufferView::bits()      const noexcept { return geti(AL_BITS); }
-ALPP_DECL int BufferView::channels()  const noexcept { return geti(AL_CHANNELS); }
+template<class CheckPolicy> ALPP_DECL size_t BasicBufferView<CheckPolicy>::frames() const noexcept {
+	int frameBytes = bits() / 8 * channels();
+	return frameBytes > 0 ? size() / frameBytes : 0;
+}
 
-ALPP_DECL int BufferView::size() const noexcept { return geti(AL_SIZE); }
+template<class CheckPolicy> ALPP_DECL std::pair<size_t, size_t> BasicBufferView<CheckPolicy>::loop_points() const noexcept {
+	int values[2] = { 0, 0 };
+	alGetBufferiv(mHandle, AL_LOOP_POINTS_SOFT, values); AL_CHECK_ERROR();
+	return { (size_t)values[0], (size_t)values[1] };
+}
+template<class CheckPolicy> ALPP_DECL void BasicBufferView<CheckPolicy>::loop_points(size_t begin, size_t end) noexcept {
+	int values[2] = { (int)begin, (int)end };
+	alBufferiv(mHandle, AL_LOOP_POINTS_SOFT, values); AL_CHECK_ERROR();
+}
 
 // =============================================================
 // == Buffer =============================================
@@ -227,6 +575,12 @@ ALPP_DECL void Buffer::gen() noexcept {
 	destroy();
 	alGenBuffers(1, &mHandle); AL_CHECK_ERROR();
 }
+ALPP_DECL void Buffer::gen(Buffer* buffers, size_t count) noexcept {
+	static_assert(sizeof(Buffer) == sizeof(unsigned));
+	for(size_t i = 0; i < count; i++)
+		buffers[i].destroy();
+	alGenBuffers(count, reinterpret_cast<unsigned*>(buffers)); AL_CHECK_ERROR();
+}
 ALPP_DECL void Buffer::destroy() noexcept {
 	if(mHandle) {
 		alDeleteBuffers(1, &mHandle); AL_CHECK_ERROR();
@@ -238,14 +592,7 @@ ALPP_DECL void Buffer::destroy() noexcept {
 // == SourceView =============================================
 // =============================================================
 
-ALPP_DECL SourceView::SourceView(unsigned handle) noexcept : mHandle(handle) {}
-
-ALPP_DECL void SourceView::play()   noexcept { alSourcePlay(mHandle);   AL_CHECK_ERROR(); }
-ALPP_DECL void SourceView::pause()  noexcept { alSourcePause(mHandle);  AL_CHECK_ERROR(); }
-ALPP_DECL void SourceView::stop()   noexcept { alSourceStop(mHandle);   AL_CHECK_ERROR(); }
-ALPP_DECL void SourceView::rewind() noexcept { alSourceRewind(mHandle); AL_CHECK_ERROR(); }
-
-ALPP_DECL void SourceView::queueBuffers(BufferView const* buffers, size_t count) noexcept {
+template<class CheckPolicy> ALPP_DECL void BasicSourceView<CheckPolicy>::queueBuffers(BufferView const* buffers, size_t count) noexcept {
 	static_assert(sizeof(BufferView) == sizeof(unsigned));
 	alSourceQueueBuffers(
 		mHandle,
@@ -253,7 +600,7 @@ ALPP_DECL void SourceView::queueBuffers(BufferView const* buffers, size_t count)
 		reinterpret_cast<unsigned const*>(buffers)
 	); AL_CHECK_ERROR();
 }
-ALPP_DECL void SourceView::unqueueBuffers(al::BufferView* buffers, size_t count) noexcept {
+template<class CheckPolicy> ALPP_DECL void BasicSourceView<CheckPolicy>::unqueueBuffers(al::BufferView* buffers, size_t count) noexcept {
 	static_assert(sizeof(BufferView) == sizeof(unsigned));
 	alSourceUnqueueBuffers(
 		mHandle,
@@ -261,88 +608,28 @@ ALPP_DECL void SourceView::unqueueBuffers(al::BufferView* buffers, size_t count)
 		reinterpret_cast<unsigned*>(buffers)
 	); AL_CHECK_ERROR();
 }
-ALPP_DECL void SourceView::queueBuffer(al::BufferView buffer) noexcept {
+template<class CheckPolicy> ALPP_DECL void BasicSourceView<CheckPolicy>::queueBuffer(al::BufferView buffer) noexcept {
 	queueBuffers(&buffer, 1);
 }
-ALPP_DECL al::BufferView SourceView::unqueueBuffer() noexcept {
+template<class CheckPolicy> ALPP_DECL al::BufferView BasicSourceView<CheckPolicy>::unqueueBuffer() noexcept {
 	al::BufferView result;
 	unqueueBuffers(&result, 1);
 	return result;
 }
 
-ALPP_DECL float     SourceView::getf(unsigned param) const noexcept {
-	float result;
-	alGetSourcef(mHandle, param, &result); AL_CHECK_ERROR();
-	return result;
-}
-ALPP_DECL int       SourceView::geti(unsigned param) const noexcept {
-	int result;
-	alGetSourcei(mHandle, param, &result); AL_CHECK_ERROR();
-	return result;
-}
-ALPP_DECL glm::vec3 SourceView::get3f(unsigned param) const noexcept {
-	glm::vec3 result;
-	alGetSourcefv(mHandle, param, &result[0]); AL_CHECK_ERROR();
-	return result;
+template<class CheckPolicy> ALPP_DECL void BasicSourceView<CheckPolicy>::label(const char* name) noexcept { alObjectLabelEXT(AL_SOURCE_EXT, mHandle, -1, name); AL_CHECK_ERROR(); }
+
+template<class CheckPolicy> ALPP_DECL int            BasicSourceView<CheckPolicy>::resampler()                 const noexcept { return geti(AL_SOURCE_RESAMPLER_SOFT); }
+template<class CheckPolicy> ALPP_DECL void           BasicSourceView<CheckPolicy>::resampler(int value)              noexcept { set(AL_SOURCE_RESAMPLER_SOFT, value); }
+template<class CheckPolicy> ALPP_DECL Spatialize     BasicSourceView<CheckPolicy>::spatialize()                const noexcept { return (Spatialize)geti(AL_SOURCE_SPATIALIZE_SOFT); }
+template<class CheckPolicy> ALPP_DECL void           BasicSourceView<CheckPolicy>::spatialize(Spatialize value)      noexcept { set(AL_SOURCE_SPATIALIZE_SOFT, (int)value); }
+template<class CheckPolicy> ALPP_DECL DirectChannels BasicSourceView<CheckPolicy>::direct_channels()           const noexcept { return (DirectChannels)geti(AL_DIRECT_CHANNELS_SOFT); }
+template<class CheckPolicy> ALPP_DECL void           BasicSourceView<CheckPolicy>::direct_channels(DirectChannels value) noexcept { set(AL_DIRECT_CHANNELS_SOFT, (int)value); }
+
+template<class CheckPolicy> ALPP_DECL void BasicSourceView<CheckPolicy>::auxiliary_send_filter(unsigned sendIndex, AuxiliaryEffectsSlotView effectsSlot, FilterView filter) noexcept {
+	alSource3i(mHandle, AL_AUXILIARY_SEND_FILTER, (ALint)(unsigned)effectsSlot, sendIndex, (ALint)(unsigned)filter); AL_CHECK_ERROR();
 }
-ALPP_DECL void SourceView::set(unsigned param, float     value) const noexcept { alSourcef(mHandle, param, value); AL_CHECK_ERROR(); }
-ALPP_DECL void SourceView::set(unsigned param, int       value) const noexcept { alSourcei(mHandle, param, value); AL_CHECK_ERROR(); }
-ALPP_DECL void SourceView::set(unsigned param, glm::vec3 value) const noexcept { alSource3f(mHandle, param, value.x, value.y, value.z); AL_CHECK_ERROR(); }
-
-ALPP_DECL float SourceView::pitch()                   const noexcept { return getf(AL_PITCH); }
-ALPP_DECL void  SourceView::pitch(float value)              noexcept { set(AL_PITCH, value); }
-ALPP_DECL float SourceView::gain()                    const noexcept { return getf(AL_GAIN); }
-ALPP_DECL void  SourceView::gain(float value)               noexcept { set(AL_GAIN, value); }
-ALPP_DECL float SourceView::max_distance()            const noexcept { return getf(AL_MAX_DISTANCE); }
-ALPP_DECL void  SourceView::max_distance(float value)       noexcept { set(AL_MAX_DISTANCE, value); }
-ALPP_DECL float SourceView::rolloff_factor()          const noexcept { return getf(AL_ROLLOFF_FACTOR); }
-ALPP_DECL void  SourceView::rolloff_factor(float value)     noexcept { set(AL_ROLLOFF_FACTOR, value); }
-ALPP_DECL float SourceView::reference_distance()      const noexcept { return getf(AL_REFERENCE_DISTANCE); }
-ALPP_DECL void  SourceView::reference_distance(float value) noexcept { set(AL_REFERENCE_DISTANCE, value); }
-
-ALPP_DECL float SourceView::min_gain()              const noexcept { return getf(AL_MIN_GAIN); }
-ALPP_DECL void  SourceView::min_gain(float value)         noexcept { set(AL_MIN_GAIN, value); }
-ALPP_DECL float SourceView::max_gain()              const noexcept { return getf(AL_MAX_GAIN); }
-ALPP_DECL void  SourceView::max_gain(float value)         noexcept { set(AL_MAX_GAIN, value); }
-ALPP_DECL float SourceView::cone_outer_gain()       const noexcept { return getf(AL_CONE_OUTER_GAIN); }
-ALPP_DECL void  SourceView::cone_outer_gain(float value)  noexcept { set(AL_CONE_OUTER_GAIN, value); }
-ALPP_DECL float SourceView::cone_inner_angle()      const noexcept { return getf(AL_CONE_INNER_ANGLE); }
-ALPP_DECL void  SourceView::cone_inner_angle(float value) noexcept { set(AL_CONE_INNER_ANGLE, value); }
-ALPP_DECL float SourceView::cone_outer_angle()      const noexcept { return getf(AL_CONE_OUTER_ANGLE); }
-ALPP_DECL void  SourceView::cone_outer_angle(float value) noexcept { set(AL_CONE_OUTER_ANGLE, value); }
-
-ALPP_DECL glm::vec3 SourceView::position ()          const noexcept { return get3f(AL_POSITION); }
-ALPP_DECL void      SourceView::position(glm::vec3 value)  noexcept { set(AL_POSITION, value); }
-ALPP_DECL glm::vec3 SourceView::velocity()           const noexcept { return get3f(AL_VELOCITY); }
-ALPP_DECL void      SourceView::velocity(glm::vec3 value)  noexcept { set(AL_VELOCITY, value); }
-ALPP_DECL glm::vec3 SourceView::direction()          const noexcept { return get3f(AL_DIRECTION); }
-ALPP_DECL void      SourceView::direction(glm::vec3 value) noexcept { set(AL_DIRECTION, value); }
-
-ALPP_DECL bool       SourceView::relative()       const noexcept { return geti(AL_SOURCE_RELATIVE); }
-ALPP_DECL void       SourceView::relative(bool value)   noexcept { set(AL_SOURCE_RELATIVE, value ? AL_TRUE : AL_FALSE); }
-ALPP_DECL SourceType SourceView::type()           const noexcept { return (SourceType)geti(AL_SOURCE_TYPE); }
-ALPP_DECL void       SourceView::type(SourceType value) noexcept { set(AL_SOURCE_TYPE, (int)value); }
-
-ALPP_DECL bool        SourceView::looping()          const noexcept { return geti(AL_LOOPING); }
-ALPP_DECL void        SourceView::looping(bool value)      noexcept { set(AL_LOOPING, value ? AL_TRUE : AL_FALSE); }
-ALPP_DECL BufferView  SourceView::buffer()           const noexcept { return BufferView(geti(AL_BUFFER)); }
-ALPP_DECL void        SourceView::buffer(BufferView value) noexcept { set(AL_BUFFER, (int)value); }
-ALPP_DECL SourceState SourceView::state()            const noexcept { return (SourceState)geti(AL_SOURCE_STATE); }
-ALPP_DECL void        SourceView::state(SourceState value) noexcept { set(AL_SOURCE_STATE, (int)value); }
-
-ALPP_DECL unsigned SourceView::buffers_queued()    const noexcept { return geti(AL_BUFFERS_QUEUED); }
-ALPP_DECL unsigned SourceView::buffers_processed() const noexcept { return geti(AL_BUFFERS_PROCESSED); }
-
-ALPP_DECL void SourceView::auxiliary_send_filter(unsigned sendIndex, AuxiliaryEffectsSlotView effectsSlot, FilterView filter) noexcept {
-	alSource3i(mHandle, AL_AUXILIARY_SEND_FILTER, effectsSlot, sendIndex, filter); AL_CHECK_ERROR();
-}
-
-ALPP_DECL float  SourceView::sec_offset()          const noexcept { return getf(AL_SEC_OFFSET); }
-ALPP_DECL void   SourceView::sec_offset(float value)     noexcept { set(AL_SEC_OFFSET, value); }
-ALPP_DECL size_t SourceView::sample_offset()       const noexcept { return geti(AL_SAMPLE_OFFSET); }
-ALPP_DECL void   SourceView::sample_offset(size_t value) noexcept { set(AL_SAMPLE_OFFSET, (int)value); }
-ALPP_DECL size_t SourceView::byte_offset()         const noexcept { return geti(AL_BYTE_OFFSET); }
-ALPP_DECL void   SourceView::byte_offset(size_t value)   noexcept { set(AL_BYTE_OFFSET, (int)value); }
+template<class CheckPolicy> ALPP_DECL void BasicSourceView<CheckPolicy>::direct_filter(FilterView filter) noexcept { set(AL_DIRECT_FILTER, (int)(unsigned)filter); }
 
 // =============================================================
 // == Source =============================================
@@ -373,11 +660,20 @@ ALPP_DECL Source& Source::operator=(Source&& src) noexcept {
 ALPP_DECL void Source::gen() noexcept {
 	destroy();
 	alGenSources(1, &mHandle); AL_CHECK_ERROR();
+	AL_STAT(activeSources, fetch_add, 1);
+}
+ALPP_DECL void Source::gen(Source* sources, size_t count) noexcept {
+	static_assert(sizeof(Source) == sizeof(unsigned));
+	for(size_t i = 0; i < count; i++)
+		sources[i].destroy();
+	alGenSources(count, reinterpret_cast<unsigned*>(sources)); AL_CHECK_ERROR();
+	AL_STAT(activeSources, fetch_add, count);
 }
 ALPP_DECL void Source::destroy() noexcept {
 	if(mHandle) {
 		alDeleteSources(1, &mHandle); AL_CHECK_ERROR();
 		mHandle = 0;
+		AL_STAT(activeSources, fetch_sub, 1);
 	}
 }
 
@@ -418,31 +714,49 @@ ALPP_DECL void Listener::orientation(glm::vec3 fwd, glm::vec3 up) noexcept {
 }
 
 // =============================================================
-// == FilterView =============================================
+// == DeferredUpdates =============================================
 // =============================================================
 
+ALPP_DECL DeferredUpdates::DeferredUpdates()  noexcept { alDeferUpdatesSOFT(); AL_CHECK_ERROR(); }
+ALPP_DECL DeferredUpdates::~DeferredUpdates() noexcept { alProcessUpdatesSOFT(); AL_CHECK_ERROR(); }
 
-ALPP_DECL FilterType FilterView::type() const noexcept {
+// =============================================================
+// == SuspendedContext =============================================
+// =============================================================
+
+ALPP_DECL SuspendedContext::SuspendedContext() noexcept : mContext(alcGetCurrentContext()) {
+	if(mContext) alcSuspendContext((ALCcontext*)mContext);
+}
+ALPP_DECL SuspendedContext::~SuspendedContext() noexcept {
+	if(mContext) alcProcessContext((ALCcontext*)mContext);
+}
+
+// =============================================================
+// == FilterView =============================================
+// =============================================================
+
+template<class CheckPolicy> ALPP_DECL FilterType BasicFilterView<CheckPolicy>::type() const noexcept {
 	ALint value;
 	alGetFilteri(mHandle, AL_FILTER_TYPE, &value); AL_CHECK_ERROR();
 	return (FilterType)value;
 }
-ALPP_DECL void FilterView::type(FilterType type) noexcept { set(AL_FILTER_TYPE, type); }
-ALPP_DECL void FilterView::lowpass_gain(float f) noexcept { set(AL_LOWPASS_GAIN, f); }
-ALPP_DECL void FilterView::lowpass_gainhf(float f) noexcept { set(AL_LOWPASS_GAINHF, f); }
-ALPP_DECL void FilterView::highpass_gain(float f) noexcept { set(AL_HIGHPASS_GAIN, f); }
-ALPP_DECL void FilterView::highpass_gainlf(float f) noexcept { set(AL_HIGHPASS_GAINLF, f); }
-ALPP_DECL void FilterView::bandpass_gain(float f) noexcept { set(AL_BANDPASS_GAIN, f); }
-ALPP_DECL void FilterView::bandpass_gainlf(float f) noexcept { set(AL_BANDPASS_GAINLF, f); }
-ALPP_DECL void FilterView::bandpass_gainhf(float f) noexcept { set(AL_BANDPASS_GAINHF, f); }
-ALPP_DECL void FilterView::set(int param, int   value) noexcept { alFilteri(mHandle, param, value); AL_CHECK_ERROR(); }
-ALPP_DECL void FilterView::set(int param, float value) noexcept { alFilterf(mHandle, param, value); AL_CHECK_ERROR(); }
-ALPP_DECL int   FilterView::geti(int param) const noexcept {
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::type(FilterType type) noexcept { set(AL_FILTER_TYPE, type); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::lowpass_gain(float f) noexcept { set(AL_LOWPASS_GAIN, f); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::lowpass_gainhf(float f) noexcept { set(AL_LOWPASS_GAINHF, f); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::highpass_gain(float f) noexcept { set(AL_HIGHPASS_GAIN, f); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::highpass_gainlf(float f) noexcept { set(AL_HIGHPASS_GAINLF, f); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::bandpass_gain(float f) noexcept { set(AL_BANDPASS_GAIN, f); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::bandpass_gainlf(float f) noexcept { set(AL_BANDPASS_GAINLF, f); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::bandpass_gainhf(float f) noexcept { set(AL_BANDPASS_GAINHF, f); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::set(int param, int   value) noexcept { alFilteri(mHandle, param, value); AL_CHECK_ERROR(); }
+template<class CheckPolicy> ALPP_DECL void BasicFilterView<CheckPolicy>::set(int param, float value) noexcept { alFilterf(mHandle, param, value); AL_CHECK_ERROR(); }
+template<class CheckPolicy> ALPP_DECL void  BasicFilterView<CheckPolicy>::label(const char* name) noexcept { alObjectLabelEXT(AL_FILTER_EXT, mHandle, -1, name); AL_CHECK_ERROR(); }
+template<class CheckPolicy> ALPP_DECL int   BasicFilterView<CheckPolicy>::geti(int param) const noexcept {
 	int result;
 	alGetFilteri(mHandle, param, &result); AL_CHECK_ERROR();
 	return result;
 }
-ALPP_DECL float FilterView::getf(int param) const noexcept {
+template<class CheckPolicy> ALPP_DECL float BasicFilterView<CheckPolicy>::getf(int param) const noexcept {
 	float result;
 	alGetFilterf(mHandle, param, &result); AL_CHECK_ERROR();
 	return result;
@@ -452,7 +766,6 @@ ALPP_DECL float FilterView::getf(int param) const noexcept {
 // == Filter =============================================
 // =============================================================
 
-
 ALPP_DECL Filter::Filter(std::nullptr_t) noexcept : FilterView() {}
 ALPP_DECL Filter::~Filter() noexcept { destroy(); }
 ALPP_DECL void Filter::gen() noexcept {
@@ -469,40 +782,41 @@ ALPP_DECL void Filter::destroy() noexcept {
 // == EffectView =============================================
 // =============================================================
 
-ALPP_DECL EffectView::EffectView(unsigned handle) noexcept :
+template<class CheckPolicy> ALPP_DECL BasicEffectView<CheckPolicy>::BasicEffectView(unsigned handle) noexcept :
 	mHandle(handle)
 {}
-ALPP_DECL void EffectView::type(EffectType effectType) noexcept {
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::type(EffectType effectType) noexcept {
 	alEffecti(mHandle, AL_EFFECT_TYPE, effectType); AL_CHECK_ERROR();
 }
-ALPP_DECL void  EffectView::set(int param, float f) noexcept { alEffectf(mHandle, param, f); AL_CHECK_ERROR(); }
-ALPP_DECL void  EffectView::set(int param, int   i) noexcept { alEffecti(mHandle, param, i); AL_CHECK_ERROR(); }
-ALPP_DECL int   EffectView::geti(int param)   const noexcept {
+template<class CheckPolicy> ALPP_DECL void  BasicEffectView<CheckPolicy>::set(int param, float f) noexcept { alEffectf(mHandle, param, f); AL_CHECK_ERROR(); }
+template<class CheckPolicy> ALPP_DECL void  BasicEffectView<CheckPolicy>::set(int param, int   i) noexcept { alEffecti(mHandle, param, i); AL_CHECK_ERROR(); }
+template<class CheckPolicy> ALPP_DECL void  BasicEffectView<CheckPolicy>::label(const char* name) noexcept { alObjectLabelEXT(AL_EFFECT_EXT, mHandle, -1, name); AL_CHECK_ERROR(); }
+template<class CheckPolicy> ALPP_DECL int   BasicEffectView<CheckPolicy>::geti(int param)   const noexcept {
 	int result;
-	alGetFilteri(mHandle, param, &result); AL_CHECK_ERROR();
+	alGetEffecti(mHandle, param, &result); AL_CHECK_ERROR();
 	return result;
 }
-ALPP_DECL float EffectView::getf(int param)   const noexcept {
+template<class CheckPolicy> ALPP_DECL float BasicEffectView<CheckPolicy>::getf(int param)   const noexcept {
 	float result;
-	alGetFilterf(mHandle, param, &result); AL_CHECK_ERROR();
+	alGetEffectf(mHandle, param, &result); AL_CHECK_ERROR();
 	return result;
 }
 
 // Reverb
 
-ALPP_DECL void EffectView::reverbDensity(float f)             noexcept { set(AL_REVERB_DENSITY, f); }
-ALPP_DECL void EffectView::reverbDiffusion(float f)           noexcept { set(AL_REVERB_DIFFUSION, f); }
-ALPP_DECL void EffectView::reverbGain(float f)                noexcept { set(AL_REVERB_GAIN, f); }
-ALPP_DECL void EffectView::reverbGainhf(float f)              noexcept { set(AL_REVERB_GAINHF, f); }
-ALPP_DECL void EffectView::reverbDecayTime(float f)           noexcept { set(AL_REVERB_DECAY_TIME, f); }
-ALPP_DECL void EffectView::reverbDecayHFRatio(float f)        noexcept { set(AL_REVERB_DECAY_HFRATIO, f); }
-ALPP_DECL void EffectView::reverbReflectionsGain(float f)     noexcept { set(AL_REVERB_REFLECTIONS_GAIN, f); }
-ALPP_DECL void EffectView::reverbReflectionsDelay(float f)    noexcept { set(AL_REVERB_REFLECTIONS_DELAY, f); }
-ALPP_DECL void EffectView::reverbLateReverbGain(float f)      noexcept { set(AL_REVERB_LATE_REVERB_GAIN, f); }
-ALPP_DECL void EffectView::reverbLateReverbDelay(float f)     noexcept { set(AL_REVERB_LATE_REVERB_DELAY, f); }
-ALPP_DECL void EffectView::reverbAirAbsorptionGainHF(float f) noexcept { set(AL_REVERB_AIR_ABSORPTION_GAINHF, f); }
-ALPP_DECL void EffectView::reverbRoomRolloffFactor(float f)   noexcept { set(AL_REVERB_ROOM_ROLLOFF_FACTOR, f); }
-ALPP_DECL void EffectView::reverbDecayHFLimit(bool f)         noexcept { set(AL_REVERB_DECAY_HFLIMIT, f?AL_TRUE:AL_FALSE); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbDensity(float f)             noexcept { set(AL_REVERB_DENSITY, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbDiffusion(float f)           noexcept { set(AL_REVERB_DIFFUSION, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbGain(float f)                noexcept { set(AL_REVERB_GAIN, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbGainhf(float f)              noexcept { set(AL_REVERB_GAINHF, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbDecayTime(float f)           noexcept { set(AL_REVERB_DECAY_TIME, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbDecayHFRatio(float f)        noexcept { set(AL_REVERB_DECAY_HFRATIO, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbReflectionsGain(float f)     noexcept { set(AL_REVERB_REFLECTIONS_GAIN, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbReflectionsDelay(float f)    noexcept { set(AL_REVERB_REFLECTIONS_DELAY, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbLateReverbGain(float f)      noexcept { set(AL_REVERB_LATE_REVERB_GAIN, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbLateReverbDelay(float f)     noexcept { set(AL_REVERB_LATE_REVERB_DELAY, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbAirAbsorptionGainHF(float f) noexcept { set(AL_REVERB_AIR_ABSORPTION_GAINHF, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbRoomRolloffFactor(float f)   noexcept { set(AL_REVERB_ROOM_ROLLOFF_FACTOR, f); }
+template<class CheckPolicy> ALPP_DECL void BasicEffectView<CheckPolicy>::reverbDecayHFLimit(bool f)         noexcept { set(AL_REVERB_DECAY_HFLIMIT, f?AL_TRUE:AL_FALSE); }
 
 // =============================================================
 // == Effect =============================================
@@ -529,13 +843,24 @@ ALPP_DECL AuxiliaryEffectsSlotView::AuxiliaryEffectsSlotView(unsigned handle) no
 	mHandle(handle)
 {}
 ALPP_DECL void AuxiliaryEffectsSlotView::effect(EffectView effect) noexcept {
-	alAuxiliaryEffectSloti(mHandle, AL_EFFECTSLOT_EFFECT, effect); AL_CHECK_ERROR();
+	alAuxiliaryEffectSloti(mHandle, AL_EFFECTSLOT_EFFECT, (ALint)(unsigned)effect); AL_CHECK_ERROR();
+}
+ALPP_DECL float AuxiliaryEffectsSlotView::gain() const noexcept {
+	float result = 0;
+	alGetAuxiliaryEffectSlotf(mHandle, AL_EFFECTSLOT_GAIN, &result); AL_CHECK_ERROR();
+	return result;
 }
 ALPP_DECL void AuxiliaryEffectsSlotView::gain(float f) noexcept {
-	alAuxiliaryEffectSlotf(mHandle, AL_EFFECTSLOT_GAIN, f);
+	alAuxiliaryEffectSlotf(mHandle, AL_EFFECTSLOT_GAIN, f); AL_CHECK_ERROR();
 }
 ALPP_DECL void AuxiliaryEffectsSlotView::auxiliarySendAuto(bool b) noexcept {
-	alAuxiliaryEffectSloti(mHandle, AL_EFFECTSLOT_AUXILIARY_SEND_AUTO, b?AL_TRUE:AL_FALSE);
+	alAuxiliaryEffectSloti(mHandle, AL_EFFECTSLOT_AUXILIARY_SEND_AUTO, b?AL_TRUE:AL_FALSE); AL_CHECK_ERROR();
+}
+ALPP_DECL void AuxiliaryEffectsSlotView::label(const char* name) noexcept {
+	alObjectLabelEXT(AL_AUXILIARY_EFFECT_SLOT_EXT, mHandle, -1, name); AL_CHECK_ERROR();
+}
+ALPP_DECL void AuxiliaryEffectsSlotView::buffer(BufferView buffer) noexcept {
+	alAuxiliaryEffectSloti(mHandle, AL_BUFFER, (ALint)(unsigned)buffer); AL_CHECK_ERROR();
 }
 
 // =============================================================
@@ -555,6 +880,21 @@ ALPP_DECL void AuxiliaryEffectsSlot::destroy() noexcept {
 	mHandle = 0;
 }
 
+#ifndef ALPP_INLINE
+template class BasicBufferView<DefaultChecking>;
+template class BasicBufferView<Checked>;
+template class BasicBufferView<Unchecked>;
+template class BasicFilterView<DefaultChecking>;
+template class BasicFilterView<Checked>;
+template class BasicFilterView<Unchecked>;
+template class BasicEffectView<DefaultChecking>;
+template class BasicEffectView<Checked>;
+template class BasicEffectView<Unchecked>;
+template class BasicSourceView<DefaultChecking>;
+template class BasicSourceView<Checked>;
+template class BasicSourceView<Unchecked>;
+#endif
+
 } // namespace al
 
 /*
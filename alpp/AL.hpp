@@ -6,7 +6,10 @@
 #include <glm/mat3x3.hpp>
 #include <glm/mat4x4.hpp>
 
-#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <system_error>
 #include <utility>
 
 namespace al {
@@ -20,8 +23,28 @@ enum class Format {
 	MonoF32   = 0x10010,
 	StereoF32 = 0x10011
 };
+
+enum class FormatError {
+	NotMono = 1,         //<! MultiChannelFormat was passed a format with more than one channel
+	UnsupportedChannels,
+	UnknownFormat,
+};
+std::error_category const& FormatCategory() noexcept;
+inline std::error_code make_error_code(FormatError e) noexcept { return { (int)e, FormatCategory() }; }
+
 Format MultiChannelFormat(Format mono, unsigned channels);
 void   DecomposeFormat(Format fmt, Format* mono, unsigned* channels);
+unsigned FrameSize(Format fmt) noexcept; //<! Bytes per frame (all channels), 0 for unknown formats
+
+// Never throw or allocate, for real-time threads
+Format MultiChannelFormat(Format mono, unsigned channels, std::error_code& error) noexcept;
+void   DecomposeFormat(Format fmt, Format* mono, unsigned* channels, std::error_code& error) noexcept;
+
+// Error checks (without NDEBUG) throw std::runtime_error when they find an AL error.
+// With ALPP_NO_EXCEPTIONS they call the error handler instead and remember the error, so nothing throws or allocates.
+using ErrorHandler = void (*)(int error, const char* message, const char* file, int line);
+void SetErrorHandler(ErrorHandler handler) noexcept;
+int  LastError() noexcept; //<! Last error (AL/ALC error or FormatError) reported on this thread with ALPP_NO_EXCEPTIONS and resets it, 0 for none
 
 enum class SourceState {
 	Initial = 0x1011,
@@ -36,6 +59,41 @@ enum class SourceType {
 	Streaming    = 0x1029,
 };
 
+// AL_SOFT_source_spatialize
+enum class Spatialize {
+	Off  = 0x0000,
+	On   = 0x0001,
+	Auto = 0x0002, //<! Spatialize mono sources only (default)
+};
+
+// AL_SOFT_direct_channels, AL_SOFT_direct_channels_remix
+enum class DirectChannels {
+	Off            = 0x0000,
+	DropUnmatched  = 0x0001, //<! Channels without a matching output are dropped
+	RemixUnmatched = 0x0002, //<! Channels without a matching output are mixed into the closest ones
+};
+
+// AL_SOFT_source_resampler
+int         ResamplerCount() noexcept;
+int         DefaultResampler() noexcept;
+const char* ResamplerName(int resampler) noexcept;
+int         FindResampler(const char* name) noexcept; //<! Index of the resampler with this name, -1 if there is none
+
+// Whether the current context supports the AL extension, e.g. "AL_SOFT_direct_channels_remix"
+bool ExtensionPresent(const char* name) noexcept;
+
+class DeviceView;
+DeviceView CurrentDevice() noexcept; //<! Device of the current context, null without one
+
+// Number of AL calls made through the wrapper so far, only counted when compiled with ALPP_COUNT_CALLS or ALPP_STATS (see Stats.hpp)
+unsigned long long CallCount() noexcept;
+
+// Playback IdleGovernor can't see through its watched sources, always maintained (unlike Stats): the number of
+// SourceView::play calls so far, and the sounds the library's players (OneShotPool, SubRangePlayer, StreamSource) keep playing right now.
+unsigned long long PlayCount() noexcept;
+long long          PlayerSounds() noexcept;
+void               AddPlayerSounds(long long delta) noexcept; //<! For players outside the library: +1 when a sound starts, -1 when it's done
+
 class DeviceView {
 protected:
 	void* mDeviceHandle = nullptr;
@@ -44,8 +102,22 @@ public:
 
 	int geti(int param) const noexcept;
 	const char* gets(int param) const noexcept;
+
+	int     frequency() const noexcept; //<! Output sample rate in Hz
+	int     sends()     const noexcept; //<! Auxiliary sends per source (ALC_MAX_AUXILIARY_SENDS)
+	int64_t latency()   const noexcept; //<! Output latency in nanoseconds (ALC_SOFT_device_clock)
 	const char* getStringISOFT(int paramName, size_t index) const noexcept;
 
+	// ALC_SOFT_loopback, only valid on devices opened with Device::OpenLoopback
+	bool loopback() const noexcept; //<! Opened with Device::OpenLoopback
+	bool isRenderFormatSupported(int frequency, int channels, int type) const noexcept;
+	void renderSamples(void* buffer, int frames) const noexcept; //<! Mixes `frames` sample frames into `buffer`, in the format the context was created with
+
+	// ALC_SOFT_pause_device, stops mixing (and the CPU it costs) while sources keep their state
+	bool canPause() const noexcept; //<! False for loopback devices, they only mix in renderSamples anyway
+	void pause()  const noexcept;
+	void resume() const noexcept;
+
 	operator bool() const noexcept { return mDeviceHandle != nullptr; }
 };
 
@@ -55,6 +127,8 @@ public:
 	Device(const char* name) noexcept;
 	~Device() noexcept;
 
+	static Device OpenLoopback(const char* name = nullptr) noexcept; //<! A device that doesn't output anywhere, mixing only happens through renderSamples
+
 	Device(Device&& other) noexcept;
 	Device& operator=(Device&& other) noexcept;
 	Device(Device const& other) noexcept            = delete;
@@ -63,15 +137,91 @@ public:
 	void* release() noexcept { return std::exchange(mDeviceHandle, nullptr); }
 };
 
+// AL_EXT_debug
+enum class DebugSource {
+	Api         = 0x19B5,
+	AudioSystem = 0x19B6,
+	ThirdParty  = 0x19B7,
+	Application = 0x19B8,
+	Other       = 0x19B9,
+};
+enum class DebugType {
+	Error              = 0x19BA,
+	DeprecatedBehavior = 0x19BB,
+	UndefinedBehavior  = 0x19BC,
+	Portability        = 0x19BD,
+	Performance        = 0x19BE,
+	Marker             = 0x19BF,
+	PushGroup          = 0x19C0,
+	PopGroup           = 0x19C1,
+	Other              = 0x19C2,
+};
+enum class DebugSeverity {
+	High         = 0x19C3,
+	Medium       = 0x19C4,
+	Low          = 0x19C5,
+	Notification = 0x19C6,
+};
+
+struct DebugMessage {
+	DebugSource   source;
+	DebugType     type;
+	DebugSeverity severity;
+	unsigned      id;
+	char          text[244]; //<! Truncated if longer
+};
+
+// Messages from AL_EXT_debug, filled by the driver's callback on whatever thread it runs on and drained by the game with pop().
+// A fixed size lock-free queue, when it is full new messages are dropped (and counted).
+class DebugLog {
+public:
+	static constexpr size_t Capacity = 256;
+
+	static DebugLog& global() noexcept;
+
+	bool push(DebugMessage const& message) noexcept; //<! false if the log was full
+	bool pop(DebugMessage& message) noexcept;        //<! false if the log was empty
+
+	size_t   size()    const noexcept; //<! Approximate while others push/pop
+	uint64_t dropped() const noexcept { return mDropped.load(std::memory_order_relaxed); }
+
+	// Messages less severe than this are discarded, the driver is told to not even send them when the context is created
+	void          minSeverity(DebugSeverity severity) noexcept { mMinSeverity.store(severity, std::memory_order_relaxed); }
+	DebugSeverity minSeverity() const noexcept { return mMinSeverity.load(std::memory_order_relaxed); }
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		DebugMessage        message;
+	};
+	Cell mCells[Capacity];
+	alignas(64) std::atomic<size_t> mHead = 0; // Next push
+	alignas(64) std::atomic<size_t> mTail = 0; // Next pop
+	std::atomic<uint64_t>      mDropped     = 0;
+	std::atomic<DebugSeverity> mMinSeverity = DebugSeverity::Low;
+
+	DebugLog() noexcept;
+};
+
 class Context {
 public:
 	class Options {
-		std::vector<int> options = { 0 };
+		static constexpr size_t Capacity = 64; // Attribute values including the terminating 0
+
+		int    options[Capacity] = {};
+		size_t count             = 0;
 	public:
 		Device device = nullptr;
-		void add(std::initializer_list<int> values) noexcept { options.insert(options.begin() + options.size() - 1, values.begin(), values.end()); }
+		bool   debug  = false; //<! Create a debug context (AL_EXT_debug) and route its messages into DebugLog::global(). Errors are then reported there instead of by polling alGetError after each call.
+
+		bool add(std::initializer_list<int> values) noexcept { //<! False if they don't fit
+			if(count + values.size() >= Capacity) return false;
+			for(int value : values) options[count++] = value;
+			options[count] = 0;
+			return true;
+		}
 
-		int const* get() const noexcept { return options.data(); }
+		int const* get() const noexcept { return options; }
 	};
 
 	Context(std::nullptr_t)  noexcept;
@@ -88,21 +238,53 @@ public:
 	void init(Options options) noexcept;
 	void close() noexcept;
 
+	explicit operator bool() const noexcept { return mContext != nullptr; }
+
 private:
 	void* mContext;
 };
 
-class BufferView {
+// Error checking policies of the object views. DefaultChecking checks unless NDEBUG, the others override that
+// per call site, e.g. `UncheckedSourceView(source).play()` in a hot loop or `CheckedBufferView(buffer).data(...)` in release builds.
+// Views of different policies convert into each other.
+struct DefaultChecking {};
+struct Checked {};
+struct Unchecked {};
+
+template<class Policy> class BasicBufferView;
+template<class Policy> class BasicFilterView;
+template<class Policy> class BasicEffectView;
+template<class Policy> class BasicSourceView;
+
+using BufferView = BasicBufferView<DefaultChecking>;
+using FilterView = BasicFilterView<DefaultChecking>;
+using EffectView = BasicEffectView<DefaultChecking>;
+using SourceView = BasicSourceView<DefaultChecking>;
+
+using CheckedBufferView   = BasicBufferView<Checked>;
+using CheckedFilterView   = BasicFilterView<Checked>;
+using CheckedEffectView   = BasicEffectView<Checked>;
+using CheckedSourceView   = BasicSourceView<Checked>;
+using UncheckedBufferView = BasicBufferView<Unchecked>;
+using UncheckedFilterView = BasicFilterView<Unchecked>;
+using UncheckedEffectView = BasicEffectView<Unchecked>;
+using UncheckedSourceView = BasicSourceView<Unchecked>;
+
+template<class Policy>
+class BasicBufferView {
 protected:
 	unsigned mHandle;
 public:
 	explicit
-	BufferView(unsigned handle = 0) noexcept;
-	BufferView(std::nullptr_t) noexcept : BufferView() {}
-	~BufferView() noexcept;
+	BasicBufferView(unsigned handle = 0) noexcept;
+	BasicBufferView(std::nullptr_t) noexcept : BasicBufferView() {}
+	template<class Other>
+	BasicBufferView(BasicBufferView<Other> other) noexcept : BasicBufferView((unsigned)other) {}
+	~BasicBufferView() noexcept;
 
 
 	void data(void const* data, size_t size, Format fmt, unsigned freq) noexcept;
+	void label(const char* name) noexcept; //<! Name shown in AL_EXT_debug messages
 
 	int geti(unsigned prop) const noexcept;
 
@@ -111,12 +293,22 @@ public:
 	int channels() const noexcept; //<! Number of channels in buffer
 
 	int size() const noexcept; //<! Buffer size
+	size_t frames() const noexcept; //<! Length in sample frames
+
+	std::pair<size_t, size_t> loop_points() const noexcept; //<! Frames [begin, end) a looping source repeats (AL_SOFT_loop_points)
+	void loop_points(size_t begin, size_t end)  noexcept; //<! Only while no source uses the buffer
 
 	operator bool() const noexcept { return mHandle != 0; }
-	explicit operator int() { return mHandle; }
-	explicit operator unsigned() { return mHandle; }
+	explicit operator int() const noexcept { return mHandle; }
+	explicit operator unsigned() const noexcept { return mHandle; }
 };
 
+#if !defined(ALPP_INLINE) && !defined(ALPP_FAST_ACCESSORS) // Otherwise the accessors in AL.inl may be instantiated inline
+extern template class BasicBufferView<DefaultChecking>;
+extern template class BasicBufferView<Checked>;
+extern template class BasicBufferView<Unchecked>;
+#endif
+
 class Buffer : public BufferView {
 public:
 	Buffer(std::nullptr_t = nullptr) noexcept;
@@ -132,6 +324,8 @@ public:
 
 	void gen() noexcept;
 	void destroy() noexcept;
+
+	static void gen(Buffer* buffers, size_t count) noexcept; //<! Generates several buffers in one call
 };
 
 enum FilterType {
@@ -141,11 +335,14 @@ enum FilterType {
 	Bandpass   = 0x0003
 };
 
-class FilterView {
+template<class Policy>
+class BasicFilterView {
 protected:
 	unsigned mHandle = 0;
 public:
-	FilterView(unsigned handle = 0) noexcept : mHandle(handle) {}
+	BasicFilterView(unsigned handle = 0) noexcept : mHandle(handle) {}
+	template<class Other>
+	BasicFilterView(BasicFilterView<Other> other) noexcept : BasicFilterView((unsigned)other) {}
 
 	FilterType type() const noexcept;
 
@@ -166,9 +363,18 @@ public:
 	int   geti(int param) const noexcept;
 	float getf(int param) const noexcept;
 
+	void label(const char* name) noexcept; //<! Name shown in AL_EXT_debug messages
+
 	operator bool() const noexcept { return mHandle; }
+	explicit operator unsigned() const noexcept { return mHandle; }
 };
 
+#if !defined(ALPP_INLINE) && !defined(ALPP_FAST_ACCESSORS)
+extern template class BasicFilterView<DefaultChecking>;
+extern template class BasicFilterView<Checked>;
+extern template class BasicFilterView<Unchecked>;
+#endif
+
 class Filter : public FilterView {
 public:
 	Filter(std::nullptr_t = nullptr) noexcept;
@@ -197,14 +403,18 @@ enum EffectType {
 	RingModulator    = 0x0009,
 	AutoWah          = 0x000A,
 	Compressor       = 0x000B,
-	Equalizer        = 0x000C
+	Equalizer        = 0x000C,
+	Convolution      = 0xA000  //<! AL_SOFT_convolution_effect, the impulse response is a buffer set on the slot, see AuxiliaryEffectsSlotView::buffer
 };
 
-class EffectView {
+template<class Policy>
+class BasicEffectView {
 protected:
 	unsigned mHandle = 0;
 public:
-	EffectView(unsigned handle = 0) noexcept;
+	BasicEffectView(unsigned handle = 0) noexcept;
+	template<class Other>
+	BasicEffectView(BasicEffectView<Other> other) noexcept : BasicEffectView((unsigned)other) {}
 
 	void type(EffectType) noexcept;
 
@@ -229,9 +439,18 @@ public:
 	int   geti(int param)   const noexcept;
 	float getf(int param)   const noexcept;
 
+	void label(const char* name) noexcept; //<! Name shown in AL_EXT_debug messages
+
 	operator bool() const noexcept { return mHandle; }
+	explicit operator unsigned() const noexcept { return mHandle; }
 };
 
+#if !defined(ALPP_INLINE) && !defined(ALPP_FAST_ACCESSORS)
+extern template class BasicEffectView<DefaultChecking>;
+extern template class BasicEffectView<Checked>;
+extern template class BasicEffectView<Unchecked>;
+#endif
+
 class Effect : public EffectView {
 public:
 	Effect(std::nullptr_t = nullptr) noexcept;
@@ -252,11 +471,15 @@ protected:
 public:
 	AuxiliaryEffectsSlotView(unsigned handle = 0) noexcept;
 
-	void effect(EffectView effect) noexcept;
-	void gain(float f) noexcept;
-	void auxiliarySendAuto(bool b) noexcept;
+	void  effect(EffectView effect) noexcept;
+	float gain() const noexcept;
+	void  gain(float f) noexcept;
+	void  auxiliarySendAuto(bool b) noexcept;
+	void buffer(BufferView buffer) noexcept; //<! Impulse response for Convolution effects, set it after effect()
+	void label(const char* name) noexcept; //<! Name shown in AL_EXT_debug messages
 
 	operator bool() const noexcept { return mHandle; }
+	explicit operator unsigned() const noexcept { return mHandle; }
 };
 
 class AuxiliaryEffectsSlot : public AuxiliaryEffectsSlotView {
@@ -273,12 +496,15 @@ public:
 	void destroy() noexcept;
 };
 
-class SourceView {
+template<class Policy>
+class BasicSourceView {
 protected:
 	unsigned mHandle;
 public:
-	SourceView(unsigned handle = 0) noexcept;
-	SourceView(std::nullptr_t) noexcept : SourceView() {}
+	BasicSourceView(unsigned handle = 0) noexcept;
+	BasicSourceView(std::nullptr_t) noexcept : BasicSourceView() {}
+	template<class Other>
+	BasicSourceView(BasicSourceView<Other> other) noexcept : BasicSourceView((unsigned)other) {}
 
 	void play() noexcept;
 	void pause() noexcept;
@@ -291,6 +517,8 @@ public:
 	void           queueBuffer(al::BufferView buffer) noexcept;
 	al::BufferView unqueueBuffer() noexcept;
 
+	void label(const char* name) noexcept; //<! Name shown in AL_EXT_debug messages
+
 
 	float     getf (unsigned prop)          const noexcept;
 	int       geti (unsigned prop)          const noexcept;
@@ -328,6 +556,13 @@ public:
 	glm::vec3 direction()    const noexcept; //<! direction vector
 	void      direction(glm::vec3) noexcept;
 
+	int            resampler()       const noexcept; //<! index of the resampler used by this source, see ResamplerName
+	void           resampler(int)          noexcept;
+	Spatialize     spatialize()      const noexcept; //<! whether the source is panned/HRTF'd by position
+	void           spatialize(Spatialize)  noexcept;
+	DirectChannels direct_channels() const noexcept; //<! play multichannel buffers straight to the matching output channels
+	void           direct_channels(DirectChannels) noexcept;
+
 	bool       relative() const noexcept; //<! determines if the positions are relative to the listener
 	void       relative(bool)   noexcept;
 	SourceType type()     const noexcept; //<! the source type – AL_UNDETERMINED, AL_STATIC, or AL_STREAMING
@@ -347,6 +582,7 @@ public:
 	unsigned buffers_processed() const noexcept; //<! the number of buffers in the queue that have been processed
 
 	void auxiliary_send_filter(unsigned sendIndex, AuxiliaryEffectsSlotView effectsSlot, FilterView filter = {}) noexcept;
+	void direct_filter(FilterView filter) noexcept; //<! Filter applied to the dry path, e.g. for occlusion
 
 	float  sec_offset()    const noexcept; //<! the playback position, expressed in seconds
 	void   sec_offset(float)     noexcept;
@@ -356,8 +592,15 @@ public:
 	void   byte_offset(size_t)   noexcept;
 
 	operator bool() const noexcept { return mHandle != 0; }
+	explicit operator unsigned() const noexcept { return mHandle; }
 };
 
+#if !defined(ALPP_INLINE) && !defined(ALPP_FAST_ACCESSORS)
+extern template class BasicSourceView<DefaultChecking>;
+extern template class BasicSourceView<Checked>;
+extern template class BasicSourceView<Unchecked>;
+#endif
+
 class Source : public SourceView {
 public:
 	Source(std::nullptr_t = nullptr) noexcept;
@@ -372,6 +615,8 @@ public:
 
 	void gen() noexcept;
 	void destroy() noexcept;
+
+	static void gen(Source* sources, size_t count) noexcept; //<! Generates several sources in one call
 };
 
 class Listener {
@@ -394,8 +639,36 @@ public:
 	static void      orientation(glm::vec3 fwd, glm::vec3 up) noexcept; //<! orientation expressed as “at” and “up” vectors
 };
 
+// Batches all changes made while it exists, they're applied together when it's destroyed (AL_SOFT_deferred_updates)
+class DeferredUpdates {
+public:
+	DeferredUpdates() noexcept;
+	~DeferredUpdates() noexcept;
+
+	DeferredUpdates(DeferredUpdates const&)            = delete;
+	DeferredUpdates& operator=(DeferredUpdates const&) = delete;
+};
+
+// Suspends processing of the current context while it exists (alcSuspendContext/alcProcessContext), so state read
+// in between is one snapshot. OpenAL Soft implements both as no-ops, there it only marks the window.
+class SuspendedContext {
+	void* mContext;
+public:
+	SuspendedContext() noexcept;
+	~SuspendedContext() noexcept;
+
+	SuspendedContext(SuspendedContext const&)            = delete;
+	SuspendedContext& operator=(SuspendedContext const&) = delete;
+};
+
 } // namespace al
 
+template<> struct std::is_error_code_enum<al::FormatError> : std::true_type {};
+
+#ifdef ALPP_FAST_ACCESSORS
+#include "AL.inl"
+#endif
+
 #if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
 #include "AL.cpp"
 #endif
@@ -0,0 +1,177 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+// Thin accessors of the views, which only forward to one AL call. AL.cpp always includes this file, AL.hpp includes it
+// too when ALPP_FAST_ACCESSORS is defined, so hot setters can be inlined (and their error checks folded) at the call site.
+// Unlike ALPP_INLINE it only pulls in <AL/al.h>, everything else stays compiled in AL.cpp.
+// The checks of DefaultChecking views are compiled into each translation unit, so those using ALPP_FAST_ACCESSORS have to
+// agree with AL.cpp on NDEBUG and AL_ERROR_CHECKING; otherwise the two copies of each accessor differ and the linker picks one.
+// The macros below are private to this file and #undef'd at its end, AL.cpp defines its own.
+
+#pragma once
+
+#include "AL.hpp"
+
+#include <AL/al.h>
+
+#include <atomic>
+#include <type_traits>
+
+#ifndef ALPP_DECL
+	#define ALPP_INL_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+#if !defined(NDEBUG) && !defined(AL_ERROR_CHECKING)
+	#define ALPP_INL_ERROR_CHECKING
+	#define AL_ERROR_CHECKING
+#endif
+
+#if defined(ALPP_STATS) && !defined(ALPP_COUNT_CALLS)
+	#define ALPP_COUNT_CALLS
+#endif
+
+#ifdef ALPP_COUNT_CALLS
+#include "Stats.hpp"
+#define AL_COUNT_CALL() al::Stats::global().alCalls.add()
+#else
+#define AL_COUNT_CALL() ((void)0)
+#endif
+
+namespace al {
+
+namespace detail {
+
+ALPP_DECL void CheckError(const char* file, int line); //<! alGetError, throws or reports what it finds
+ALPP_DECL bool DebugOutputActive() noexcept; //<! The current context is a debug context
+ALPP_DECL std::atomic<uint64_t>& PlayCounter() noexcept;
+
+template<class Policy>
+constexpr bool ChecksErrors = std::is_same_v<Policy, Checked>
+#ifdef AL_ERROR_CHECKING
+	|| std::is_same_v<Policy, DefaultChecking>
+#endif
+	;
+
+} // namespace detail
+
+} // namespace al
+
+// Only used in the view members below, which see their template parameter as CheckPolicy
+#define AL_CHECK_ERROR() (AL_COUNT_CALL(), al::detail::ChecksErrors<CheckPolicy> && !al::detail::DebugOutputActive() ? al::detail::CheckError(__FILE__, __LINE__) : (void)0)
+
+namespace al {
+
+// =============================================================
+// == BufferView =============================================
+// =============================================================
+
+template<class CheckPolicy> inline BasicBufferView<CheckPolicy>::BasicBufferView(unsigned handle) noexcept : mHandle(handle) {}
+template<class CheckPolicy> inline BasicBufferView<CheckPolicy>::~BasicBufferView() noexcept {}
+
+template<class CheckPolicy> inline int BasicBufferView<CheckPolicy>::geti(unsigned param) const noexcept {
+	int result;
+	alGetBufferi(mHandle, param, &result); AL_CHECK_ERROR();
+	return result;
+}
+
+template<class CheckPolicy> inline int BasicBufferView<CheckPolicy>::frequency() const noexcept { return geti(AL_FREQUENCY); }
+template<class CheckPolicy> inline int BasicBufferView<CheckPolicy>::bits()      const noexcept { return geti(AL_BITS); }
+template<class CheckPolicy> inline int BasicBufferView<CheckPolicy>::channels()  const noexcept { return geti(AL_CHANNELS); }
+template<class CheckPolicy> inline int BasicBufferView<CheckPolicy>::size()      const noexcept { return geti(AL_SIZE); }
+
+// =============================================================
+// == SourceView =============================================
+// =============================================================
+
+template<class CheckPolicy> inline BasicSourceView<CheckPolicy>::BasicSourceView(unsigned handle) noexcept : mHandle(handle) {}
+
+template<class CheckPolicy> inline void BasicSourceView<CheckPolicy>::play()   noexcept { alSourcePlay(mHandle);   AL_CHECK_ERROR(); detail::PlayCounter().fetch_add(1, std::memory_order_relaxed); }
+template<class CheckPolicy> inline void BasicSourceView<CheckPolicy>::pause()  noexcept { alSourcePause(mHandle);  AL_CHECK_ERROR(); }
+template<class CheckPolicy> inline void BasicSourceView<CheckPolicy>::stop()   noexcept { alSourceStop(mHandle);   AL_CHECK_ERROR(); }
+template<class CheckPolicy> inline void BasicSourceView<CheckPolicy>::rewind() noexcept { alSourceRewind(mHandle); AL_CHECK_ERROR(); }
+
+template<class CheckPolicy> inline float     BasicSourceView<CheckPolicy>::getf(unsigned param) const noexcept {
+	float result;
+	alGetSourcef(mHandle, param, &result); AL_CHECK_ERROR();
+	return result;
+}
+template<class CheckPolicy> inline int       BasicSourceView<CheckPolicy>::geti(unsigned param) const noexcept {
+	int result;
+	alGetSourcei(mHandle, param, &result); AL_CHECK_ERROR();
+	return result;
+}
+template<class CheckPolicy> inline glm::vec3 BasicSourceView<CheckPolicy>::get3f(unsigned param) const noexcept {
+	glm::vec3 result;
+	alGetSourcefv(mHandle, param, &result[0]); AL_CHECK_ERROR();
+	return result;
+}
+template<class CheckPolicy> inline void BasicSourceView<CheckPolicy>::set(unsigned param, float     value) const noexcept { alSourcef(mHandle, param, value); AL_CHECK_ERROR(); }
+template<class CheckPolicy> inline void BasicSourceView<CheckPolicy>::set(unsigned param, int       value) const noexcept { alSourcei(mHandle, param, value); AL_CHECK_ERROR(); }
+template<class CheckPolicy> inline void BasicSourceView<CheckPolicy>::set(unsigned param, glm::vec3 value) const noexcept { alSource3f(mHandle, param, value.x, value.y, value.z); AL_CHECK_ERROR(); }
+
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::pitch()                   const noexcept { return getf(AL_PITCH); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::pitch(float value)              noexcept { set(AL_PITCH, value); }
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::gain()                    const noexcept { return getf(AL_GAIN); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::gain(float value)               noexcept { set(AL_GAIN, value); }
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::max_distance()            const noexcept { return getf(AL_MAX_DISTANCE); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::max_distance(float value)       noexcept { set(AL_MAX_DISTANCE, value); }
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::rolloff_factor()          const noexcept { return getf(AL_ROLLOFF_FACTOR); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::rolloff_factor(float value)     noexcept { set(AL_ROLLOFF_FACTOR, value); }
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::reference_distance()      const noexcept { return getf(AL_REFERENCE_DISTANCE); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::reference_distance(float value) noexcept { set(AL_REFERENCE_DISTANCE, value); }
+
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::min_gain()              const noexcept { return getf(AL_MIN_GAIN); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::min_gain(float value)         noexcept { set(AL_MIN_GAIN, value); }
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::max_gain()              const noexcept { return getf(AL_MAX_GAIN); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::max_gain(float value)         noexcept { set(AL_MAX_GAIN, value); }
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::cone_outer_gain()       const noexcept { return getf(AL_CONE_OUTER_GAIN); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::cone_outer_gain(float value)  noexcept { set(AL_CONE_OUTER_GAIN, value); }
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::cone_inner_angle()      const noexcept { return getf(AL_CONE_INNER_ANGLE); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::cone_inner_angle(float value) noexcept { set(AL_CONE_INNER_ANGLE, value); }
+template<class CheckPolicy> inline float BasicSourceView<CheckPolicy>::cone_outer_angle()      const noexcept { return getf(AL_CONE_OUTER_ANGLE); }
+template<class CheckPolicy> inline void  BasicSourceView<CheckPolicy>::cone_outer_angle(float value) noexcept { set(AL_CONE_OUTER_ANGLE, value); }
+
+template<class CheckPolicy> inline glm::vec3 BasicSourceView<CheckPolicy>::position ()          const noexcept { return get3f(AL_POSITION); }
+template<class CheckPolicy> inline void      BasicSourceView<CheckPolicy>::position(glm::vec3 value)  noexcept { set(AL_POSITION, value); }
+template<class CheckPolicy> inline glm::vec3 BasicSourceView<CheckPolicy>::velocity()           const noexcept { return get3f(AL_VELOCITY); }
+template<class CheckPolicy> inline void      BasicSourceView<CheckPolicy>::velocity(glm::vec3 value)  noexcept { set(AL_VELOCITY, value); }
+template<class CheckPolicy> inline glm::vec3 BasicSourceView<CheckPolicy>::direction()          const noexcept { return get3f(AL_DIRECTION); }
+template<class CheckPolicy> inline void      BasicSourceView<CheckPolicy>::direction(glm::vec3 value) noexcept { set(AL_DIRECTION, value); }
+
+template<class CheckPolicy> inline bool       BasicSourceView<CheckPolicy>::relative()       const noexcept { return geti(AL_SOURCE_RELATIVE); }
+template<class CheckPolicy> inline void       BasicSourceView<CheckPolicy>::relative(bool value)   noexcept { set(AL_SOURCE_RELATIVE, value ? AL_TRUE : AL_FALSE); }
+template<class CheckPolicy> inline SourceType BasicSourceView<CheckPolicy>::type()           const noexcept { return (SourceType)geti(AL_SOURCE_TYPE); }
+template<class CheckPolicy> inline void       BasicSourceView<CheckPolicy>::type(SourceType value) noexcept { set(AL_SOURCE_TYPE, (int)value); }
+template<class CheckPolicy> inline bool        BasicSourceView<CheckPolicy>::looping()          const noexcept { return geti(AL_LOOPING); }
+template<class CheckPolicy> inline void        BasicSourceView<CheckPolicy>::looping(bool value)      noexcept { set(AL_LOOPING, value ? AL_TRUE : AL_FALSE); }
+template<class CheckPolicy> inline BufferView  BasicSourceView<CheckPolicy>::buffer()           const noexcept { return BufferView(geti(AL_BUFFER)); }
+template<class CheckPolicy> inline void        BasicSourceView<CheckPolicy>::buffer(BufferView value) noexcept { set(AL_BUFFER, (int)value); }
+template<class CheckPolicy> inline SourceState BasicSourceView<CheckPolicy>::state()            const noexcept { return (SourceState)geti(AL_SOURCE_STATE); }
+template<class CheckPolicy> inline void        BasicSourceView<CheckPolicy>::state(SourceState value) noexcept { set(AL_SOURCE_STATE, (int)value); }
+
+template<class CheckPolicy> inline unsigned BasicSourceView<CheckPolicy>::buffers_queued()    const noexcept { return geti(AL_BUFFERS_QUEUED); }
+template<class CheckPolicy> inline unsigned BasicSourceView<CheckPolicy>::buffers_processed() const noexcept { return geti(AL_BUFFERS_PROCESSED); }
+
+template<class CheckPolicy> inline float  BasicSourceView<CheckPolicy>::sec_offset()          const noexcept { return getf(AL_SEC_OFFSET); }
+template<class CheckPolicy> inline void   BasicSourceView<CheckPolicy>::sec_offset(float value)     noexcept { set(AL_SEC_OFFSET, value); }
+template<class CheckPolicy> inline size_t BasicSourceView<CheckPolicy>::sample_offset()       const noexcept { return geti(AL_SAMPLE_OFFSET); }
+template<class CheckPolicy> inline void   BasicSourceView<CheckPolicy>::sample_offset(size_t value) noexcept { set(AL_SAMPLE_OFFSET, (int)value); }
+template<class CheckPolicy> inline size_t BasicSourceView<CheckPolicy>::byte_offset()         const noexcept { return geti(AL_BYTE_OFFSET); }
+template<class CheckPolicy> inline void   BasicSourceView<CheckPolicy>::byte_offset(size_t value)   noexcept { set(AL_BYTE_OFFSET, (int)value); }
+
+} // namespace al
+
+#undef AL_CHECK_ERROR
+#undef AL_COUNT_CALL
+#ifdef ALPP_INL_ERROR_CHECKING
+	#undef AL_ERROR_CHECKING
+	#undef ALPP_INL_ERROR_CHECKING
+#endif
+#ifdef ALPP_INL_DECL
+	#undef ALPP_DECL
+	#undef ALPP_INL_DECL
+#endif
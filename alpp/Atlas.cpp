@@ -0,0 +1,83 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Atlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == SoundAtlas =============================================
+// =============================================================
+
+ALPP_DECL SubRange SoundAtlas::find(std::string const& name) const noexcept {
+	auto iter = mNames.find(name);
+	return iter == mNames.end() ? SubRange() : mClips[iter->second];
+}
+
+// =============================================================
+// == SoundAtlasBuilder =============================================
+// =============================================================
+
+ALPP_DECL SoundAtlasBuilder::SoundAtlasBuilder(Format format, unsigned frequency, size_t pageFrames, size_t gapFrames) :
+	mFormat(format),
+	mFrequency(frequency),
+	mFrameSize(FrameSize(format)),
+	mPageFrames(std::max<size_t>(pageFrames, 1)),
+	mGapFrames(gapFrames)
+{}
+
+ALPP_DECL size_t SoundAtlasBuilder::add(std::string name, void const* data, size_t bytes) {
+	if(mFrameSize == 0 || bytes % mFrameSize != 0) return SIZE_MAX;
+
+	size_t frames = bytes / mFrameSize;
+	size_t needed = frames + mGapFrames;
+
+	auto page = std::find_if(mPages.begin(), mPages.end(), [&](Page const& p) { return p.frames + needed <= mPageFrames; });
+	if(page == mPages.end()) {
+		mPages.emplace_back();
+		page = mPages.end() - 1;
+		page->data.reserve(std::max(needed, mPageFrames) * mFrameSize);
+	}
+
+	// 8 bit formats are unsigned, their silence is 0x80
+	uint8_t silence = mFormat == Format::Mono8 || mFormat == Format::Stereo8 ? 0x80 : 0;
+
+	size_t begin = page->frames;
+	auto   src   = static_cast<uint8_t const*>(data);
+	page->data.insert(page->data.end(), src, src + bytes);
+	page->data.insert(page->data.end(), mGapFrames * mFrameSize, silence);
+	page->frames += needed;
+
+	mClips.push_back({ std::move(name), (size_t)(page - mPages.begin()), begin, frames });
+	return mClips.size() - 1;
+}
+
+ALPP_DECL SoundAtlas SoundAtlasBuilder::build() {
+	SoundAtlas atlas;
+	atlas.mBuffers.resize(mPages.size());
+	Buffer::gen(atlas.mBuffers.data(), atlas.mBuffers.size());
+	for(size_t i = 0; i < mPages.size(); i++)
+		atlas.mBuffers[i].data(mPages[i].data.data(), mPages[i].data.size(), mFormat, mFrequency);
+
+	atlas.mClips.reserve(mClips.size());
+	for(auto& clip : mClips) {
+		atlas.mNames.emplace(std::move(clip.name), atlas.mClips.size());
+		atlas.mClips.push_back({ BufferView((unsigned)atlas.mBuffers[clip.page]), clip.begin, clip.begin + clip.frames });
+	}
+
+	mPages.clear();
+	mClips.clear();
+	return atlas;
+}
+
+} // namespace al
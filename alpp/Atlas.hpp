@@ -0,0 +1,70 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "SubRange.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace al {
+
+// Many short clips of the same format packed into a few large buffers. Play them with a SubRangePlayer:
+//     player.play(source, atlas.find("click"));
+class SoundAtlas {
+	friend class SoundAtlasBuilder;
+
+	std::vector<Buffer>                     mBuffers;
+	std::vector<SubRange>                   mClips;
+	std::unordered_map<std::string, size_t> mNames;
+public:
+	SoundAtlas() noexcept = default;
+
+	SubRange clip(size_t index) const noexcept { return mClips[index]; } //<! Index as returned by SoundAtlasBuilder::add
+	SubRange find(std::string const& name) const noexcept;                //<! Empty range if there's no such clip
+
+	size_t clipCount()   const noexcept { return mClips.size(); }
+	size_t bufferCount() const noexcept { return mBuffers.size(); }
+};
+
+// Collects clips and packs them into pages of `pageFrames` (first fit, clips longer than a page get their own).
+// Every clip is followed by `gapFrames` of silence, which is what plays while a SubRangePlayer hasn't stopped the source yet.
+class SoundAtlasBuilder {
+	struct Page {
+		std::vector<uint8_t> data;
+		size_t               frames = 0; // Used, including gaps
+	};
+	struct Clip {
+		std::string name;
+		size_t      page;
+		size_t      begin;
+		size_t      frames;
+	};
+
+	Format   mFormat;
+	unsigned mFrequency;
+	unsigned mFrameSize;
+	size_t   mPageFrames;
+	size_t   mGapFrames;
+
+	std::vector<Page> mPages;
+	std::vector<Clip> mClips;
+public:
+	SoundAtlasBuilder(Format format, unsigned frequency, size_t pageFrames = 1 << 20, size_t gapFrames = 2048);
+
+	// Copies the clip, `bytes` has to be a multiple of the frame size. Returns the clip's index, or SIZE_MAX if the size doesn't fit the format.
+	size_t add(std::string name, void const* data, size_t bytes);
+
+	SoundAtlas build(); //<! Uploads all pages, one buffer each, and empties the builder
+
+	size_t clipCount() const noexcept { return mClips.size(); }
+	size_t pageCount() const noexcept { return mPages.size(); }
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Atlas.cpp"
+#endif
@@ -0,0 +1,172 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Attachment.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+namespace detail {
+
+#ifdef ALPP_SIMD_SSE2
+// (float)(a[0..3] - b[0..3]), the subtraction in double precision
+ALPP_DECL __m128 Difference(double const* a, double const* b) noexcept {
+	__m128 lo = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(a),     _mm_loadu_pd(b)));
+	__m128 hi = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+	return _mm_movelh_ps(lo, hi);
+}
+#endif
+
+} // namespace detail
+
+// =============================================================
+// == EmitterRig =============================================
+// =============================================================
+
+ALPP_DECL size_t EmitterRig::addNode(size_t parent) {
+	mParent.push_back(parent);
+	mLocalPosition.emplace_back(0.0);
+	mWorldPosition.emplace_back(0.0);
+	mLocalRotation.emplace_back(1.f);
+	mWorldRotation.emplace_back(1.f);
+	mTeleported.push_back(false);
+	return mParent.size() - 1;
+}
+
+ALPP_DECL void EmitterRig::transform(size_t node, glm::dvec3 position, glm::mat3 const& rotation) noexcept {
+	mLocalPosition[node] = position;
+	mLocalRotation[node] = rotation;
+}
+
+ALPP_DECL void EmitterRig::teleport(size_t node) noexcept {
+	mTeleported[node] = true;
+}
+
+ALPP_DECL void EmitterRig::clear() noexcept {
+	for(Handle emitter : mEmitters)
+		mScene.remove(emitter);
+	for(auto* v : { &mParent, &mNodes }) v->clear();
+	mEmitters.clear();
+	for(auto* v : { &mLocalPosition, &mWorldPosition }) v->clear();
+	for(auto* v : { &mLocalRotation, &mWorldRotation }) v->clear();
+	for(auto* v : { &mX, &mY, &mZ, &mPrevX, &mPrevY, &mPrevZ }) v->clear();
+	for(auto* v : { &mVelX, &mVelY, &mVelZ }) v->clear();
+	mTeleported.clear();
+	mSources.clear();
+	mOffsets.clear();
+}
+
+ALPP_DECL Handle EmitterRig::attach(SourceView source, size_t node, glm::vec3 offset) {
+	constexpr double unknown = std::numeric_limits<double>::quiet_NaN(); // No velocity until there's a previous position
+	mEmitters.push_back(mScene.add(source, mWorldPosition[node]));
+	mSources.push_back(source);
+	mNodes.push_back(node);
+	mOffsets.push_back(offset);
+	for(auto* v : { &mX, &mY, &mZ, &mPrevX, &mPrevY, &mPrevZ })
+		v->push_back(unknown);
+	for(auto* v : { &mVelX, &mVelY, &mVelZ })
+		v->push_back(0.f);
+	return mEmitters.back();
+}
+
+ALPP_DECL void EmitterRig::detach(SourceView source) noexcept {
+	for(size_t i = 0; i < mSources.size(); i++) {
+		if((unsigned)mSources[i] != (unsigned)source) continue;
+
+		mScene.remove(mEmitters[i]);
+
+		mSources[i]  = mSources.back();  mSources.pop_back();
+		mNodes[i]    = mNodes.back();    mNodes.pop_back();
+		mEmitters[i] = mEmitters.back(); mEmitters.pop_back();
+		mOffsets[i]  = mOffsets.back();  mOffsets.pop_back();
+		for(auto* v : { &mX, &mY, &mZ, &mPrevX, &mPrevY, &mPrevZ }) {
+			(*v)[i] = v->back();
+			v->pop_back();
+		}
+		for(auto* v : { &mVelX, &mVelY, &mVelZ }) {
+			(*v)[i] = v->back();
+			v->pop_back();
+		}
+		return;
+	}
+}
+
+ALPP_DECL void EmitterRig::update(float seconds) noexcept {
+	// Parents come first, so one pass resolves the hierarchy
+	for(size_t n = 0; n < mParent.size(); n++) {
+		size_t parent = mParent[n];
+		if(parent == NoParent) {
+			mWorldPosition[n] = mLocalPosition[n];
+			mWorldRotation[n] = mLocalRotation[n];
+			continue;
+		}
+		glm::mat3 const& rotation = mWorldRotation[parent];
+		mWorldPosition[n] = mWorldPosition[parent] + glm::dvec3(rotation * glm::vec3(mLocalPosition[n]));
+		mWorldRotation[n] = glm::mat3(rotation * mLocalRotation[n][0], rotation * mLocalRotation[n][1], rotation * mLocalRotation[n][2]);
+	}
+
+	size_t count = mSources.size();
+	for(size_t i = 0; i < count; i++) {
+		size_t node = mNodes[i];
+		glm::dvec3 position = mWorldPosition[node] + glm::dvec3(mWorldRotation[node] * mOffsets[i]);
+		mX[i] = position.x;
+		mY[i] = position.y;
+		mZ[i] = position.z;
+		if(mTeleported[node])
+			mPrevX[i] = std::numeric_limits<double>::quiet_NaN();
+	}
+	std::fill(mTeleported.begin(), mTeleported.end(), false);
+
+	// velocity = (position - previous) / seconds, dropped when faster than maxSpeed (NaN from unknown previous positions fails the compare too)
+	float invSeconds = seconds > 0 ? 1.f / seconds : 0.f;
+	float maxSpeed2  = mMaxSpeed * mMaxSpeed;
+	mTeleports = 0;
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128 inv = _mm_set1_ps(invSeconds), max2 = _mm_set1_ps(maxSpeed2);
+	for(; i + 4 <= count; i += 4) {
+		__m128 vx = _mm_mul_ps(detail::Difference(&mX[i], &mPrevX[i]), inv);
+		__m128 vy = _mm_mul_ps(detail::Difference(&mY[i], &mPrevY[i]), inv);
+		__m128 vz = _mm_mul_ps(detail::Difference(&mZ[i], &mPrevZ[i]), inv);
+		__m128 speed2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+		__m128 valid  = _mm_cmple_ps(speed2, max2);
+		int bits = _mm_movemask_ps(valid);
+		mTeleports += 4 - ((bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1));
+		_mm_storeu_ps(&mVelX[i], _mm_and_ps(valid, vx));
+		_mm_storeu_ps(&mVelY[i], _mm_and_ps(valid, vy));
+		_mm_storeu_ps(&mVelZ[i], _mm_and_ps(valid, vz));
+	}
+#endif
+	for(; i < count; i++) {
+		glm::vec3 v((float)(mX[i] - mPrevX[i]), (float)(mY[i] - mPrevY[i]), (float)(mZ[i] - mPrevZ[i]));
+		v *= invSeconds;
+		if(!(glm::dot(v, v) <= maxSpeed2)) {
+			v = glm::vec3(0.f);
+			mTeleports++;
+		}
+		mVelX[i] = v.x;
+		mVelY[i] = v.y;
+		mVelZ[i] = v.z;
+	}
+	std::copy(mX.begin(), mX.end(), mPrevX.begin());
+	std::copy(mY.begin(), mY.end(), mPrevY.begin());
+	std::copy(mZ.begin(), mZ.end(), mPrevZ.begin());
+
+	for(i = 0; i < count; i++) {
+		mScene.position(mEmitters[i], glm::dvec3(mX[i], mY[i], mZ[i])); // Does nothing if someone else removed it
+		mScene.velocity(mEmitters[i], glm::vec3(mVelX[i], mVelY[i], mVelZ[i]));
+	}
+	mScene.update();
+}
+
+} // namespace al
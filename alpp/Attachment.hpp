@@ -0,0 +1,62 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "Spatial.hpp"
+
+#include <glm/mat3x3.hpp>
+#include <glm/vec3.hpp>
+
+#include <vector>
+
+namespace al {
+
+// Binds sources to transform nodes (a car, its wheels, a character's hand) with a local offset. Once per tick the game
+// sets the node transforms, update() then computes the world position of every attached source and its velocity by
+// finite differences with SIMD, and submits both through the SpatialScene in one deferred batch.
+// Velocities above `maxSpeed` are taken as teleports (respawns, cuts) and submitted as zero instead of a Doppler sweep.
+class EmitterRig {
+public:
+	static constexpr size_t NoParent = ~size_t(0);
+
+	explicit EmitterRig(SpatialScene& scene, float maxSpeed = 300.f) noexcept : mScene(scene), mMaxSpeed(maxSpeed) {}
+
+	size_t addNode(size_t parent = NoParent); //<! Parents have to be added before their children. Returns the node index.
+	void   transform(size_t node, glm::dvec3 position, glm::mat3 const& rotation) noexcept; //<! Relative to the parent, world space for roots
+	void   teleport(size_t node) noexcept; //<! The node jumped, its sources get no velocity on the next update
+	void   clear() noexcept; //<! Removes all nodes and detaches all sources
+
+	Handle attach(SourceView source, size_t node, glm::vec3 offset = glm::vec3(0.f)); //<! Adds the source to the scene, returns its emitter there
+	void   detach(SourceView source) noexcept; //<! And removes it from the scene. Sources someone else removed from the scene are skipped.
+
+	void update(float seconds) noexcept; //<! Time since the last update, for the velocities. Also updates the scene.
+
+	size_t     attached()                 const noexcept { return mSources.size(); }
+	glm::dvec3 worldPosition(size_t node) const noexcept { return mWorldPosition[node]; }
+	size_t     teleports()                const noexcept { return mTeleports; } //<! Velocities dropped by the last update(), including fresh attachments
+
+private:
+	SpatialScene& mScene;
+	float         mMaxSpeed;
+	size_t        mTeleports = 0;
+
+	// Nodes
+	std::vector<size_t>     mParent;
+	std::vector<glm::dvec3> mLocalPosition, mWorldPosition;
+	std::vector<glm::mat3>  mLocalRotation, mWorldRotation;
+	std::vector<bool>       mTeleported;
+
+	// Attached sources as structure of arrays
+	std::vector<SourceView> mSources;
+	std::vector<size_t>     mNodes;
+	std::vector<Handle>     mEmitters;
+	std::vector<glm::vec3>  mOffsets;
+	std::vector<double>     mX, mY, mZ, mPrevX, mPrevY, mPrevZ;
+	std::vector<float>      mVelX, mVelY, mVelZ;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Attachment.cpp"
+#endif
@@ -0,0 +1,256 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Automation.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+namespace detail {
+
+#ifdef ALPP_SIMD_SSE2
+// e^x, relative error around 1e-7
+ALPP_DECL __m128 ExpApprox(__m128 x) noexcept {
+	x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-87.f)), _mm_set1_ps(88.f));
+	__m128 t  = _mm_mul_ps(x, _mm_set1_ps(1.44269504f)); // log2(e)
+	__m128 fi = _mm_cvtepi32_ps(_mm_cvttps_epi32(t));
+	fi = _mm_sub_ps(fi, _mm_and_ps(_mm_cmpgt_ps(fi, t), _mm_set1_ps(1.f))); // floor
+	__m128 f  = _mm_sub_ps(t, fi);
+
+	// 2^f on [0, 1)
+	__m128 p = _mm_set1_ps(1.8775767e-3f);
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(8.9893397e-3f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(5.5826318e-2f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(2.4015361e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(6.9315308e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(9.9999994e-1f));
+
+	__m128i e = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(fi), _mm_set1_epi32(127)), 23);
+	return _mm_mul_ps(p, _mm_castsi128_ps(e));
+}
+#endif
+
+} // namespace detail
+
+// =============================================================
+// == AutomationEngine =============================================
+// =============================================================
+
+ALPP_DECL AutomationEngine::AutomationEngine(std::chrono::milliseconds interval, size_t capacity, ThreadConfig thread) :
+	mCommands(std::max<size_t>(capacity, 16)),
+	mCapacity(capacity),
+	mInterval(interval)
+{
+	size_t padded = (capacity + 3) & ~size_t(3);
+	mKeys.resize(padded);
+	for(auto* v : { &mFrom, &mTo, &mTime, &mInvDuration, &mSmooth, &mExp, &mValue, &mApplied })
+		v->resize(padded, 0.f);
+	mDirtySlots.reserve(capacity);
+
+	if(interval.count() > 0)
+		mThread = std::thread([this, thread = std::move(thread)]() { ApplyThreadConfig(thread); run(); });
+}
+
+ALPP_DECL AutomationEngine::~AutomationEngine() noexcept {
+	if(mThread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+		}
+		mWake.notify_all();
+		mThread.join();
+	}
+}
+
+ALPP_DECL bool AutomationEngine::push(Key key, float target, float seconds, Curve curve) noexcept {
+	size_t head = mHead.load(std::memory_order_relaxed);
+	if(head - mTail.load(std::memory_order_acquire) == mCommands.size()) return false;
+	mCommands[head % mCommands.size()] = { key, target, seconds, curve };
+	mHead.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+ALPP_DECL bool AutomationEngine::ramp(SourceView source, unsigned param, float target, float seconds, Curve curve) noexcept {
+	return push({ Kind::Source, (unsigned)source, 0, (int)param }, target, seconds, curve);
+}
+ALPP_DECL bool AutomationEngine::ramp(AuxiliaryEffectsSlotView slot, EffectView effect, int param, float target, float seconds, Curve curve) noexcept {
+	return push({ Kind::Effect, (unsigned)effect, (unsigned)slot, param }, target, seconds, curve);
+}
+ALPP_DECL bool AutomationEngine::rampGain(AuxiliaryEffectsSlotView slot, float target, float seconds, Curve curve) noexcept {
+	return push({ Kind::SlotGain, (unsigned)slot, 0, 0 }, target, seconds, curve);
+}
+ALPP_DECL bool AutomationEngine::rampListenerGain(float target, float seconds, Curve curve) noexcept {
+	return push({ Kind::ListenerGain, 0, 0, 0 }, target, seconds, curve);
+}
+
+ALPP_DECL void AutomationEngine::cancel(SourceView source) noexcept {
+	std::lock_guard<std::mutex> lock(mTickMutex);
+	drain(); // So queued ramps for the source don't start later
+	for(size_t i = 0; i < mCount;) {
+		if(mKeys[i].kind == Kind::Source && mKeys[i].handle == (unsigned)source)
+			remove(i);
+		else
+			i++;
+	}
+	mActive.store(mCount, std::memory_order_relaxed);
+}
+
+ALPP_DECL void AutomationEngine::drain() noexcept {
+	size_t tail = mTail.load(std::memory_order_relaxed);
+	size_t head = mHead.load(std::memory_order_acquire);
+	for(; tail != head; tail++)
+		start(mCommands[tail % mCommands.size()]);
+	mTail.store(tail, std::memory_order_release);
+}
+
+ALPP_DECL float AutomationEngine::current(Key const& key) const noexcept {
+	switch(key.kind) {
+	case Kind::Source:       return SourceView(key.handle).getf(key.param);
+	case Kind::Effect:       return EffectView(key.handle).getf(key.param);
+	case Kind::SlotGain:     return AuxiliaryEffectsSlotView(key.handle).gain();
+	case Kind::ListenerGain: return Listener::gain();
+	}
+	return 0;
+}
+
+ALPP_DECL void AutomationEngine::start(Command const& command) noexcept {
+	size_t index = std::find(mKeys.begin(), mKeys.begin() + mCount, command.key) - mKeys.begin();
+
+	float from;
+	if(index < mCount) {
+		from = mValue[index]; // Continue from where the running curve is
+	}
+	else {
+		if(mCount == mCapacity) {
+			mDropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		from = current(command.key);
+		mKeys[index]    = command.key;
+		mApplied[index] = from;
+		mCount++;
+	}
+
+	float to  = command.target;
+	bool  exp = command.curve == Curve::Exponential && from > 0 && to > 0;
+	mFrom[index]        = exp ? std::log(from) : from;
+	mTo[index]          = exp ? std::log(to)   : to;
+	mExp[index]         = exp ? 1.f : 0.f;
+	mSmooth[index]      = command.curve == Curve::SCurve ? 1.f : 0.f;
+	mTime[index]        = 0;
+	mInvDuration[index] = command.seconds > 0 ? 1.f / command.seconds : 1e30f;
+	mValue[index]       = from;
+}
+
+ALPP_DECL void AutomationEngine::apply(Key const& key, float value) noexcept {
+	switch(key.kind) {
+	case Kind::Source:       SourceView(key.handle).set((unsigned)key.param, value); break;
+	case Kind::SlotGain:     AuxiliaryEffectsSlotView(key.handle).gain(value); break;
+	case Kind::ListenerGain: Listener::gain(value); break;
+	case Kind::Effect: {
+		EffectView(key.handle).set(key.param, value);
+		std::pair<unsigned, unsigned> slot { key.slot, key.handle };
+		if(std::find(mDirtySlots.begin(), mDirtySlots.end(), slot) == mDirtySlots.end())
+			mDirtySlots.push_back(slot); // Reserved up front
+		break;
+	}
+	}
+}
+
+ALPP_DECL void AutomationEngine::remove(size_t index) noexcept {
+	size_t last = mCount - 1;
+	mKeys[index]        = mKeys[last];
+	mFrom[index]        = mFrom[last];
+	mTo[index]          = mTo[last];
+	mTime[index]        = mTime[last];
+	mInvDuration[index] = mInvDuration[last];
+	mSmooth[index]      = mSmooth[last];
+	mExp[index]         = mExp[last];
+	mValue[index]       = mValue[last];
+	mApplied[index]     = mApplied[last];
+	mCount--;
+}
+
+ALPP_DECL void AutomationEngine::tick(float seconds) noexcept {
+	std::lock_guard<std::mutex> lock(mTickMutex);
+	drain();
+	if(mCount == 0) {
+		mActive.store(0, std::memory_order_relaxed);
+		return;
+	}
+
+	// value = from + (to - from) * shape(t), exponential curves are interpolated in log space
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128 dt = _mm_set1_ps(seconds), one = _mm_set1_ps(1.f), three = _mm_set1_ps(3.f), two = _mm_set1_ps(2.f), half = _mm_set1_ps(0.5f);
+	for(; i < mCount; i += 4) {
+		__m128 time = _mm_add_ps(_mm_loadu_ps(&mTime[i]), dt);
+		_mm_storeu_ps(&mTime[i], time);
+		__m128 t = _mm_min_ps(_mm_mul_ps(time, _mm_loadu_ps(&mInvDuration[i])), one);
+		__m128 smooth = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(three, _mm_mul_ps(two, t)));
+		__m128 s = _mm_add_ps(t, _mm_mul_ps(_mm_loadu_ps(&mSmooth[i]), _mm_sub_ps(smooth, t)));
+		__m128 from = _mm_loadu_ps(&mFrom[i]);
+		__m128 v = _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&mTo[i]), from), s));
+		__m128 isExp = _mm_cmpgt_ps(_mm_loadu_ps(&mExp[i]), half);
+		v = _mm_or_ps(_mm_and_ps(isExp, detail::ExpApprox(v)), _mm_andnot_ps(isExp, v));
+		_mm_storeu_ps(&mValue[i], v);
+	}
+#else
+	for(; i < mCount; i++) {
+		mTime[i] += seconds;
+		float t = std::min(mTime[i] * mInvDuration[i], 1.f);
+		float s = t + mSmooth[i] * (t * t * (3 - 2 * t) - t);
+		float v = mFrom[i] + (mTo[i] - mFrom[i]) * s;
+		mValue[i] = mExp[i] > 0.5f ? std::exp(v) : v;
+	}
+#endif
+	for(i = 0; i < mCount; i++) { // Land exactly on the target
+		if(mTime[i] * mInvDuration[i] >= 1.f)
+			mValue[i] = mExp[i] > 0.5f ? std::exp(mTo[i]) : mTo[i];
+	}
+
+	{
+		DeferredUpdates batch;
+		for(i = 0; i < mCount; i++) {
+			if(mValue[i] != mApplied[i]) {
+				apply(mKeys[i], mValue[i]);
+				mApplied[i] = mValue[i];
+			}
+		}
+		for(auto [slot, effect] : mDirtySlots)
+			AuxiliaryEffectsSlotView(slot).effect(EffectView(effect));
+		mDirtySlots.clear();
+	}
+
+	for(i = 0; i < mCount;) {
+		if(mTime[i] * mInvDuration[i] >= 1.f)
+			remove(i);
+		else
+			i++;
+	}
+	mActive.store(mCount, std::memory_order_relaxed);
+}
+
+ALPP_DECL void AutomationEngine::run() noexcept {
+	using Clock = std::chrono::steady_clock;
+
+	auto last = Clock::now();
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(!mWake.wait_for(lock, mInterval, [this]() { return mStop; })) {
+		auto now = Clock::now();
+		tick(std::chrono::duration<float>(now - last).count());
+		last = now;
+	}
+}
+
+} // namespace al
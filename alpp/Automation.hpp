@@ -0,0 +1,103 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+#include "Thread.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace al {
+
+enum class Curve {
+	Linear,
+	Exponential, //<! Constant ratio per second, for gains and pitch. Linear if either end isn't positive.
+	SCurve,      //<! Smoothstep, starts and ends slowly
+};
+
+// Ramps source, effect, slot and listener parameters at control rate. The game thread only schedules curves,
+// a control thread evaluates all of them each tick (with SIMD) and applies the changed values in one deferred batch.
+// Scheduling a parameter that's already ramping continues from its current value.
+class AutomationEngine {
+public:
+	// With a zero interval no thread is started and tick() has to be called by hand.
+	// `capacity` is the maximum number of curves running at the same time, nothing is allocated after construction.
+	explicit AutomationEngine(std::chrono::milliseconds interval = std::chrono::milliseconds(10), size_t capacity = 4096, ThreadConfig thread = { "alpp-automation" });
+	~AutomationEngine() noexcept;
+
+	AutomationEngine(AutomationEngine const&)            = delete;
+	AutomationEngine& operator=(AutomationEngine const&) = delete;
+
+	// Scheduling is lock free but single producer: call these from one thread only. They return false if the command queue is full.
+	bool ramp(SourceView source, unsigned param, float target, float seconds, Curve curve = Curve::Linear) noexcept; //<! A float property like AL_GAIN or AL_PITCH
+	bool ramp(AuxiliaryEffectsSlotView slot, EffectView effect, int param, float target, float seconds, Curve curve = Curve::Linear) noexcept; //<! Reloads the effect into the slot
+	bool rampGain(AuxiliaryEffectsSlotView slot, float target, float seconds, Curve curve = Curve::Linear) noexcept;
+	bool rampListenerGain(float target, float seconds, Curve curve = Curve::Linear) noexcept;
+
+	void cancel(SourceView source) noexcept; //<! Drops all curves of the source, call before destroying it. Blocks for a running tick.
+
+	void tick(float seconds) noexcept; //<! Advances all curves, called by the control thread
+
+	size_t   active()  const noexcept { return mActive.load(std::memory_order_relaxed); }
+	uint64_t dropped() const noexcept { return mDropped.load(std::memory_order_relaxed); } //<! Curves that didn't fit into `capacity`
+
+private:
+	enum class Kind : uint8_t { Source, Effect, SlotGain, ListenerGain };
+
+	struct Key {
+		Kind     kind;
+		unsigned handle; // Source, effect or slot
+		unsigned slot;   // For effects
+		int      param;
+
+		bool operator==(Key const& other) const noexcept { return kind == other.kind && handle == other.handle && slot == other.slot && param == other.param; }
+	};
+	struct Command {
+		Key   key;
+		float target;
+		float seconds;
+		Curve curve;
+	};
+
+	// Single producer/single consumer ring, the consumer side only runs under mTickMutex
+	std::vector<Command> mCommands;
+	std::atomic<size_t>  mHead = 0;
+	alignas(64) std::atomic<size_t> mTail = 0;
+
+	// Curves as structure of arrays, padded to a multiple of 4
+	std::mutex         mTickMutex;
+	size_t             mCapacity;
+	size_t             mCount = 0;
+	std::vector<Key>   mKeys;
+	std::vector<float> mFrom, mTo, mTime, mInvDuration, mSmooth, mExp, mValue, mApplied;
+	std::vector<std::pair<unsigned, unsigned>> mDirtySlots; // Slot, effect
+
+	std::atomic<size_t>   mActive  = 0;
+	std::atomic<uint64_t> mDropped = 0;
+
+	std::chrono::milliseconds mInterval;
+	std::mutex                mMutex;
+	std::condition_variable   mWake;
+	bool                      mStop = false;
+	std::thread               mThread;
+
+	bool  push(Key key, float target, float seconds, Curve curve) noexcept;
+	void  drain() noexcept;
+	void  start(Command const& command) noexcept;
+	float current(Key const& key) const noexcept;
+	void  apply(Key const& key, float value) noexcept;
+	void  remove(size_t index) noexcept;
+	void  run() noexcept;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Automation.cpp"
+#endif
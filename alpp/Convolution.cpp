@@ -0,0 +1,193 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Convolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+namespace detail {
+
+// Blackman windowed sinc, IRs are only resampled once at load time so quality wins over speed
+ALPP_DECL std::vector<float> ResampleSinc(float const* in, size_t frames, unsigned channels, unsigned from, unsigned to) {
+	if(from == to || from == 0 || to == 0)
+		return std::vector<float>(in, in + frames * channels);
+
+	constexpr double pi        = 3.14159265358979323846;
+	constexpr int    halfWidth = 32; // Zero crossings on each side
+
+	double ratio     = (double)to / from;
+	double cutoff    = std::min(1.0, ratio); // Lowpass at the lower of the two nyquist frequencies
+	int    taps      = (int)std::ceil(halfWidth / cutoff);
+	size_t outFrames = (size_t)std::ceil(frames * ratio);
+
+	std::vector<float> out(outFrames * channels, 0.f);
+	std::vector<double> weights(taps * 2);
+	for(size_t o = 0; o < outFrames; o++) {
+		double pos    = o / ratio;
+		long   center = (long)std::floor(pos);
+
+		for(int k = 0; k < taps * 2; k++) {
+			double x = pos - (center - taps + 1 + k);
+			double t = x / taps;
+			double window = std::abs(t) >= 1 ? 0 : 0.42 + 0.5 * std::cos(pi * t) + 0.08 * std::cos(2 * pi * t);
+			double sinc   = x == 0 ? 1 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+			weights[k] = cutoff * sinc * window;
+		}
+		for(unsigned c = 0; c < channels; c++) {
+			double sum = 0;
+			for(int k = 0; k < taps * 2; k++) {
+				long i = center - taps + 1 + k;
+				if(i < 0 || i >= (long)frames) continue;
+				sum += in[i * channels + c] * weights[k];
+			}
+			out[o * channels + c] = (float)sum;
+		}
+	}
+	return out;
+}
+
+} // namespace detail
+
+ALPP_DECL std::vector<float> PrepareImpulseResponse(float const* samples, size_t frames, unsigned channels, unsigned frequency, ImpulseResponseOptions const& options) {
+	std::error_code error;
+	return PrepareImpulseResponse(samples, frames, channels, frequency, options, error);
+}
+ALPP_DECL std::vector<float> PrepareImpulseResponse(float const* samples, size_t frames, unsigned channels, unsigned frequency, ImpulseResponseOptions const& options, std::error_code& error) {
+	error.clear();
+	if(channels == 0) {
+		error = FormatError::UnsupportedChannels;
+		return {};
+	}
+
+	unsigned targetFrequency = options.frequency ? options.frequency : frequency;
+
+	std::vector<float> result = detail::ResampleSinc(samples, frames, channels, frequency, targetFrequency);
+	frames = result.size() / channels;
+
+	// Truncate with a raised cosine fade out
+	if(options.maxSeconds > 0) {
+		size_t maxFrames = (size_t)(options.maxSeconds * targetFrequency);
+		if(frames > maxFrames) {
+			frames = maxFrames;
+			result.resize(frames * channels);
+
+			size_t fadeFrames = std::min(frames, (size_t)(options.fadeSeconds * targetFrequency));
+			for(size_t f = 0; f < fadeFrames; f++) {
+				float gain = 0.5f + 0.5f * std::cos(3.14159265f * (f + 1) / fadeFrames);
+				for(unsigned c = 0; c < channels; c++)
+					result[(frames - fadeFrames + f) * channels + c] *= gain;
+			}
+		}
+	}
+
+	float scale = 1;
+	switch(options.normalization) {
+		case ImpulseResponseOptions::None: break;
+		case ImpulseResponseOptions::Peak: {
+			float peak = 0;
+			for(float s : result) peak = std::max(peak, std::abs(s));
+			if(peak > 0) scale = 1 / peak;
+		} break;
+		case ImpulseResponseOptions::Energy: {
+			double energy = 0;
+			for(unsigned c = 0; c < channels; c++) {
+				double channelEnergy = 0;
+				for(size_t f = 0; f < frames; f++)
+					channelEnergy += (double)result[f * channels + c] * result[f * channels + c];
+				energy = std::max(energy, channelEnergy);
+			}
+			if(energy > 0) scale = (float)(1 / std::sqrt(energy));
+		} break;
+	}
+	if(scale != 1)
+		for(float& s : result) s *= scale;
+
+	return result;
+}
+
+// =============================================================
+// == ImpulseResponseCache =============================================
+// =============================================================
+
+ALPP_DECL bool ImpulseResponseCache::Matches(Entry const& entry, unsigned frequency, ImpulseResponseOptions const& options) noexcept {
+	return entry.frequency             == frequency
+	    && entry.options.frequency     == options.frequency
+	    && entry.options.maxSeconds    == options.maxSeconds
+	    && entry.options.fadeSeconds   == options.fadeSeconds
+	    && entry.options.normalization == options.normalization;
+}
+
+ALPP_DECL std::shared_ptr<Buffer> ImpulseResponseCache::find(const char* name) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto iter = mEntries.find(name);
+	if(iter == mEntries.end()) return nullptr;
+	for(Entry& entry : iter->second)
+		if(auto buffer = entry.buffer.lock())
+			return buffer;
+	return nullptr;
+}
+
+ALPP_DECL std::shared_ptr<Buffer> ImpulseResponseCache::load(const char* name, float const* samples, size_t frames, unsigned channels, unsigned frequency, ImpulseResponseOptions const& options) {
+	std::error_code error;
+	return load(name, samples, frames, channels, frequency, options, error);
+}
+ALPP_DECL std::shared_ptr<Buffer> ImpulseResponseCache::load(const char* name, float const* samples, size_t frames, unsigned channels, unsigned frequency, ImpulseResponseOptions const& options, std::error_code& error) {
+	// Validate before preprocessing, a channel count the buffer can't take would only fail after the resampling
+	Format format = MultiChannelFormat(Format::MonoF32, channels, error);
+	if(error) return nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto iter = mEntries.find(name);
+		if(iter != mEntries.end())
+			for(Entry& entry : iter->second)
+				if(Matches(entry, frequency, options))
+					if(auto existing = entry.buffer.lock())
+						return existing;
+	}
+
+	// Preprocess without holding the lock, it can take a while for long IRs
+	std::vector<float> prepared = PrepareImpulseResponse(samples, frames, channels, frequency, options, error);
+	if(error) return nullptr;
+	auto buffer = std::make_shared<Buffer>(
+		prepared.data(), prepared.size() * sizeof(float),
+		format,
+		options.frequency ? options.frequency : frequency
+	);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto& entries = mEntries[name];
+	for(Entry& entry : entries) {
+		if(!Matches(entry, frequency, options)) continue;
+		if(auto raced = entry.buffer.lock()) // Someone else loaded it in the meantime
+			return raced;
+		entry.buffer = buffer;
+		return buffer;
+	}
+	entries.push_back({ frequency, options, buffer });
+	return buffer;
+}
+
+ALPP_DECL void ImpulseResponseCache::collect() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	for(auto iter = mEntries.begin(); iter != mEntries.end();) {
+		auto& entries = iter->second;
+		entries.erase(std::remove_if(entries.begin(), entries.end(), [](Entry const& entry) { return entry.buffer.expired(); }), entries.end());
+		if(entries.empty())
+			iter = mEntries.erase(iter);
+		else
+			++iter;
+	}
+}
+
+} // namespace al
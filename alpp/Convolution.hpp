@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace al {
+
+struct ImpulseResponseOptions {
+	enum Normalization {
+		None,
+		Peak,   //<! Loudest sample at 1
+		Energy, //<! Sum of squares at 1 for the loudest channel, keeps the perceived level of the wet signal consistent between IRs
+	};
+
+	unsigned      frequency     = 0;      //<! Target sample rate, use the device's (DeviceView::frequency())
+	float         maxSeconds    = 0;      //<! Truncate longer IRs, 0 keeps the full length
+	float         fadeSeconds   = 0.05f;  //<! Fade out before the truncation point to avoid a click in the tail
+	Normalization normalization = Energy;
+};
+
+// Resamples, truncates and normalizes an interleaved float impulse response. Returns the processed samples, interleaved with the same channel count.
+// Returns an empty vector for channels == 0, the error_code overload reports FormatError::UnsupportedChannels.
+std::vector<float> PrepareImpulseResponse(float const* samples, size_t frames, unsigned channels, unsigned frequency, ImpulseResponseOptions const& options);
+std::vector<float> PrepareImpulseResponse(float const* samples, size_t frames, unsigned channels, unsigned frequency, ImpulseResponseOptions const& options, std::error_code& error);
+
+// Prepared impulse responses uploaded to buffers, shared between all slots using the same IR.
+// A buffer stays loaded as long as someone holds the shared_ptr.
+// Entries are keyed by name, source frequency and options: loading the same name with different options prepares a separate buffer.
+// Channel counts that can't be uploaded (0 or more than 2) are rejected before any processing, load returns nullptr and the
+// error_code overload reports the FormatError from MultiChannelFormat.
+//
+//   auto ir = cache.load("cathedral", samples, frames, 2, 44100, { context.device().frequency() });
+//   effect.type(al::Convolution);
+//   slot.effect(effect);
+//   slot.buffer(*ir);
+class ImpulseResponseCache {
+	struct Entry {
+		unsigned               frequency;
+		ImpulseResponseOptions options;
+		std::weak_ptr<Buffer>  buffer;
+	};
+
+	std::mutex mMutex;
+	std::unordered_map<std::string, std::vector<Entry>> mEntries;
+
+	static bool Matches(Entry const& entry, unsigned frequency, ImpulseResponseOptions const& options) noexcept;
+public:
+	std::shared_ptr<Buffer> find(const char* name); //<! nullptr if not loaded, any loaded variant if it was loaded with several options
+	std::shared_ptr<Buffer> load(const char* name, float const* samples, size_t frames, unsigned channels, unsigned frequency, ImpulseResponseOptions const& options);
+	std::shared_ptr<Buffer> load(const char* name, float const* samples, size_t frames, unsigned channels, unsigned frequency, ImpulseResponseOptions const& options, std::error_code& error);
+
+	void collect(); //<! Drops entries of IRs that are no longer in use
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Convolution.cpp"
+#endif
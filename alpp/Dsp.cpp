@@ -0,0 +1,266 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Dsp.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == DspNode =============================================
+// =============================================================
+
+ALPP_DECL DspNode::~DspNode() noexcept {}
+
+ALPP_DECL DspNodeStats DspNode::stats() const noexcept {
+	return {
+		mBlocks.load(std::memory_order_relaxed),
+		mFrames.load(std::memory_order_relaxed),
+		mNanoseconds.load(std::memory_order_relaxed),
+	};
+}
+ALPP_DECL void DspNode::resetStats() noexcept {
+	mBlocks.store(0, std::memory_order_relaxed);
+	mFrames.store(0, std::memory_order_relaxed);
+	mNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+// =============================================================
+// == DspChain =============================================
+// =============================================================
+
+ALPP_DECL DspChain::DspChain() noexcept {}
+ALPP_DECL DspChain::~DspChain() noexcept {}
+
+ALPP_DECL void DspChain::process(DspBlock block) noexcept {
+	using Clock = std::chrono::steady_clock;
+
+	auto t = Clock::now();
+	for(auto& node : mNodes) {
+		node->process(block);
+
+		auto now = Clock::now();
+		node->mBlocks.fetch_add(1, std::memory_order_relaxed);
+		node->mFrames.fetch_add(block.frames, std::memory_order_relaxed);
+		node->mNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - t).count(), std::memory_order_relaxed);
+		t = now;
+	}
+}
+
+// =============================================================
+// == DspPool =============================================
+// =============================================================
+
+ALPP_DECL DspPool::DspPool(unsigned threads, ThreadConfig thread) noexcept {
+	if(threads == 0) threads = 1;
+	for(unsigned i = 0; i < threads; i++)
+		mThreads.emplace_back([this, thread, i]() { ApplyThreadConfig(thread, (int)i); work(); });
+}
+ALPP_DECL DspPool::~DspPool() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWake.notify_all();
+	for(auto& thread : mThreads)
+		thread.join();
+}
+
+ALPP_DECL void DspPool::submit(DspChain& chain, DspBlock block, std::function<void(DspBlock)> done) {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		chain.mPending.push_back({ block, std::move(done) });
+		if(chain.mScheduled) return; // A worker is already on it and will pick this block up after the current one
+		chain.mScheduled = true;
+		mReady.push_back(&chain);
+	}
+	mWake.notify_one();
+}
+
+ALPP_DECL void DspPool::work() noexcept {
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(true) {
+		mWake.wait(lock, [this]() { return mStop || !mReady.empty(); });
+		if(mReady.empty()) return; // Stopping, and everything submitted has been processed
+
+		DspChain* chain = mReady.front();
+		mReady.pop_front();
+		DspChain::Job job = std::move(chain->mPending.front());
+		chain->mPending.pop_front();
+
+		lock.unlock();
+		chain->process(job.block);
+		if(job.done) job.done(job.block);
+		lock.lock();
+
+		if(chain->mPending.empty())
+			chain->mScheduled = false;
+		else
+			mReady.push_back(chain);
+	}
+}
+
+// =============================================================
+// == GainNode =============================================
+// =============================================================
+
+ALPP_DECL void GainNode::process(DspBlock block) noexcept {
+	simd::scale(block.samples, block.count(), gain.load(std::memory_order_relaxed));
+}
+
+// =============================================================
+// == BitcrusherNode =============================================
+// =============================================================
+
+ALPP_DECL void BitcrusherNode::process(DspBlock block) noexcept {
+	unsigned b = bits.load(std::memory_order_relaxed);
+	if(b > 0 && b < 24)
+		simd::quantize(block.samples, block.count(), (float)(1u << (b - 1)));
+
+	unsigned n = downsample.load(std::memory_order_relaxed);
+	if(n <= 1) return;
+
+	unsigned channels = std::min(block.channels, DspBlock::MaxChannels);
+	for(size_t f = 0; f < block.frames; f++) {
+		float* frame = block.samples + f * block.channels;
+		if(mHoldCounter == 0) {
+			for(unsigned c = 0; c < channels; c++) mHeld[c] = frame[c];
+		}
+		else {
+			for(unsigned c = 0; c < channels; c++) frame[c] = mHeld[c];
+		}
+		mHoldCounter = (mHoldCounter + 1) % n;
+	}
+}
+
+// =============================================================
+// == BiquadNode =============================================
+// =============================================================
+
+ALPP_DECL BiquadNode::BiquadNode(Type type, float frequency, float q, float gainDb) noexcept {
+	configure(type, frequency, q, gainDb);
+}
+
+ALPP_DECL void BiquadNode::configure(Type type, float frequency, float q, float gainDb) noexcept {
+	mType      = type;
+	mFrequency = frequency;
+	mQ         = q;
+	mGainDb    = gainDb;
+	mSampleRate = 0; // Recalculate on next block
+}
+
+ALPP_DECL void BiquadNode::updateCoefficients(unsigned sampleRate) noexcept {
+	mSampleRate = sampleRate;
+
+	// 0 Hz and Nyquist make sin(w0) zero, i.e. inf/NaN coefficients
+	float rate      = (float)std::max(sampleRate, 2u);
+	float frequency = std::clamp(mFrequency, 1.f, rate * 0.4995f);
+
+	float A     = std::pow(10.f, mGainDb / 40.f);
+	float w0    = 2.f * 3.14159265f * frequency / rate;
+	float cosw  = std::cos(w0);
+	float alpha = std::sin(w0) / (2.f * mQ);
+	float sqA   = 2.f * std::sqrt(A) * alpha;
+
+	float b0, b1, b2, a0, a1, a2;
+	switch(mType) {
+		case Lowpass:   b0 = (1 - cosw) / 2; b1 = 1 - cosw;    b2 = b0;           a0 = 1 + alpha;     a1 = -2 * cosw; a2 = 1 - alpha; break;
+		case Highpass:  b0 = (1 + cosw) / 2; b1 = -(1 + cosw); b2 = b0;           a0 = 1 + alpha;     a1 = -2 * cosw; a2 = 1 - alpha; break;
+		case Bandpass:  b0 = alpha;          b1 = 0;           b2 = -alpha;       a0 = 1 + alpha;     a1 = -2 * cosw; a2 = 1 - alpha; break;
+		case Peaking:   b0 = 1 + alpha * A;  b1 = -2 * cosw;   b2 = 1 - alpha * A; a0 = 1 + alpha / A; a1 = -2 * cosw; a2 = 1 - alpha / A; break;
+		case LowShelf:
+			b0 =     A * ((A + 1) - (A - 1) * cosw + sqA);
+			b1 = 2 * A * ((A - 1) - (A + 1) * cosw);
+			b2 =     A * ((A + 1) - (A - 1) * cosw - sqA);
+			a0 =          (A + 1) + (A - 1) * cosw + sqA;
+			a1 =    -2 * ((A - 1) + (A + 1) * cosw);
+			a2 =          (A + 1) + (A - 1) * cosw - sqA;
+			break;
+		case HighShelf:
+		default:
+			b0 =      A * ((A + 1) + (A - 1) * cosw + sqA);
+			b1 = -2 * A * ((A - 1) + (A + 1) * cosw);
+			b2 =      A * ((A + 1) + (A - 1) * cosw - sqA);
+			a0 =           (A + 1) - (A - 1) * cosw + sqA;
+			a1 =      2 * ((A - 1) - (A + 1) * cosw);
+			a2 =           (A + 1) - (A - 1) * cosw - sqA;
+			break;
+	}
+
+	mB0 = b0 / a0; mB1 = b1 / a0; mB2 = b2 / a0;
+	mA1 = a1 / a0; mA2 = a2 / a0;
+}
+
+ALPP_DECL void BiquadNode::process(DspBlock block) noexcept {
+	if(mSampleRate != block.frequency) updateCoefficients(block.frequency);
+	unsigned channels = std::min(block.channels, DspBlock::MaxChannels);
+	if(mChannels != channels) {
+		mState.fill(0.f);
+		mChannels = channels;
+	}
+
+	// Transposed direct form II, the recursion is inherently serial per channel
+	for(unsigned c = 0; c < channels; c++) {
+		float z1 = mState[c * 2], z2 = mState[c * 2 + 1];
+		float* x = block.samples + c;
+		for(size_t f = 0; f < block.frames; f++, x += block.channels) {
+			float in  = *x;
+			float out = mB0 * in + z1;
+			z1 = mB1 * in - mA1 * out + z2;
+			z2 = mB2 * in - mA2 * out;
+			*x = out;
+		}
+		mState[c * 2] = z1; mState[c * 2 + 1] = z2;
+	}
+}
+
+// =============================================================
+// == CompressorNode =============================================
+// =============================================================
+
+ALPP_DECL void CompressorNode::process(DspBlock block) noexcept {
+	if(block.frames == 0 || block.channels == 0) return;
+	unsigned channels = std::min(block.channels, DspBlock::MaxChannels);
+
+	float threshold = thresholdDb.load(std::memory_order_relaxed);
+	float slope     = 1.f - 1.f / std::fmax(1.f, ratio.load(std::memory_order_relaxed));
+	float makeup    = std::pow(10.f, makeupDb.load(std::memory_order_relaxed) / 20.f);
+	float att       = std::exp(-1.f / (std::fmax(attack.load(std::memory_order_relaxed), 1e-5f) * block.frequency));
+	float rel       = std::exp(-1.f / (std::fmax(release.load(std::memory_order_relaxed), 1e-5f) * block.frequency));
+
+	// Envelope and gain per frame (serial), then apply the chunk's gains in one SIMD pass
+	size_t chunk = mGains.size() / channels;
+	for(size_t start = 0; start < block.frames; start += chunk) {
+		size_t frames  = std::min(chunk, block.frames - start);
+		float* samples = block.samples + start * block.channels;
+
+		for(size_t f = 0; f < frames; f++) {
+			float level = simd::peak(samples + f * block.channels, channels);
+			float coeff = level > mEnvelope ? att : rel;
+			mEnvelope = level + coeff * (mEnvelope - level);
+
+			float levelDb = 20.f * std::log10(std::fmax(mEnvelope, 1e-6f));
+			float overDb  = levelDb - threshold;
+			float gain    = overDb > 0 ? std::pow(10.f, -overDb * slope / 20.f) : 1.f;
+			for(unsigned c = 0; c < channels; c++)
+				mGains[f * channels + c] = gain * makeup;
+		}
+		if(channels == block.channels)
+			simd::multiply(samples, mGains.data(), frames * channels);
+		else for(size_t f = 0; f < frames; f++) // Skipping the extra channels of each frame
+			simd::multiply(samples + f * block.channels, mGains.data() + f * channels, channels);
+	}
+}
+
+} // namespace al
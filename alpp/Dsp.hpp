@@ -0,0 +1,182 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+#include "Thread.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace al {
+
+// Interleaved float samples, processed in place. Nodes never copy or reallocate the samples,
+// so a block goes from the decoder through the whole chain into BufferView::data without copies.
+struct DspBlock {
+	float*   samples   = nullptr;
+	size_t   frames    = 0;
+	unsigned channels  = 1;
+	unsigned frequency = 0;
+
+	static constexpr unsigned MaxChannels = 16; //<! Up to 3rd order ambisonics. Node state is sized for this, extra channels are left untouched.
+
+	size_t count() const noexcept { return frames * channels; } //<! Number of samples
+};
+
+struct DspNodeStats {
+	uint64_t blocks      = 0;
+	uint64_t frames      = 0;
+	uint64_t nanoseconds = 0; //<! Time spent in process()
+};
+
+class DspNode {
+	friend class DspChain;
+
+	std::atomic<uint64_t> mBlocks      = 0;
+	std::atomic<uint64_t> mFrames      = 0;
+	std::atomic<uint64_t> mNanoseconds = 0;
+public:
+	virtual ~DspNode() noexcept;
+
+	virtual void        process(DspBlock block) noexcept = 0;
+	virtual const char* name() const noexcept = 0;
+
+	DspNodeStats stats() const noexcept;
+	void         resetStats() noexcept;
+};
+
+// An ordered list of nodes applied to every block of one stream
+class DspChain {
+	friend class DspPool;
+
+	std::vector<std::unique_ptr<DspNode>> mNodes;
+
+	// Scheduling state, owned by the DspPool the chain is submitted to
+	struct Job {
+		DspBlock                      block;
+		std::function<void(DspBlock)> done;
+	};
+	std::deque<Job> mPending;
+	bool            mScheduled = false;
+public:
+	DspChain() noexcept;
+	~DspChain() noexcept;
+
+	DspChain(DspChain const&)            = delete;
+	DspChain& operator=(DspChain const&) = delete;
+
+	template<class Node, class... Args>
+	Node& add(Args&&... args) {
+		mNodes.push_back(std::make_unique<Node>(std::forward<Args>(args)...));
+		return static_cast<Node&>(*mNodes.back());
+	}
+
+	void process(DspBlock block) noexcept; //<! Runs all nodes on the calling thread
+
+	size_t   size() const noexcept { return mNodes.size(); }
+	DspNode& operator[](size_t i) noexcept { return *mNodes[i]; }
+};
+
+// Worker threads processing blocks. Blocks submitted to the same chain are processed in order, one at a time,
+// blocks of different chains run in parallel.
+class DspPool {
+	std::vector<std::thread> mThreads;
+	std::mutex               mMutex;
+	std::condition_variable  mWake;
+	std::deque<DspChain*>    mReady;
+	bool                     mStop = false;
+public:
+	explicit DspPool(unsigned threads = std::thread::hardware_concurrency(), ThreadConfig thread = { "alpp-dsp" }) noexcept;
+	~DspPool() noexcept;
+
+	DspPool(DspPool const&)            = delete;
+	DspPool& operator=(DspPool const&) = delete;
+
+	// Processes the block on a worker, then calls done(block) on that worker, e.g. to upload it with BufferView::data and queue it.
+	// The chain has to outlive all blocks submitted to it.
+	void submit(DspChain& chain, DspBlock block, std::function<void(DspBlock)> done);
+
+private:
+	void work() noexcept;
+};
+
+// =============================================================
+// == Nodes =============================================
+// =============================================================
+
+class GainNode : public DspNode {
+public:
+	std::atomic<float> gain;
+
+	explicit GainNode(float gain = 1.f) noexcept : gain(gain) {}
+	void        process(DspBlock block) noexcept override;
+	const char* name() const noexcept override { return "gain"; }
+};
+
+// Reduces bit depth and sample rate, e.g. for radio chatter
+class BitcrusherNode : public DspNode {
+	std::array<float, DspBlock::MaxChannels> mHeld {}; // Last sample per channel, for downsampling
+	unsigned           mHoldCounter = 0;
+public:
+	std::atomic<unsigned> bits;
+	std::atomic<unsigned> downsample; //<! Keep every n-th frame
+
+	explicit BitcrusherNode(unsigned bits = 8, unsigned downsample = 1) noexcept : bits(bits), downsample(downsample) {}
+	void        process(DspBlock block) noexcept override;
+	const char* name() const noexcept override { return "bitcrusher"; }
+};
+
+// RBJ cookbook biquad, building block for custom EQs
+class BiquadNode : public DspNode {
+public:
+	enum Type { Lowpass, Highpass, Bandpass, Peaking, LowShelf, HighShelf };
+
+	BiquadNode(Type type, float frequency, float q = 0.7071f, float gainDb = 0.f) noexcept;
+
+	void configure(Type type, float frequency, float q = 0.7071f, float gainDb = 0.f) noexcept; //<! Not thread safe with process()
+
+	void        process(DspBlock block) noexcept override;
+	const char* name() const noexcept override { return "biquad"; }
+private:
+	Type  mType;
+	float mFrequency, mQ, mGainDb;
+
+	unsigned mSampleRate = 0;
+	float    mB0 = 1, mB1 = 0, mB2 = 0, mA1 = 0, mA2 = 0;
+	std::array<float, DspBlock::MaxChannels * 2> mState {}; // z1, z2 per channel
+	unsigned mChannels = 0;
+
+	void updateCoefficients(unsigned sampleRate) noexcept;
+};
+
+// Feed-forward peak compressor, the envelope is shared by all channels (up to MaxChannels, the rest is left untouched)
+class CompressorNode : public DspNode {
+	float mEnvelope = 0;
+	std::array<float, 64 * DspBlock::MaxChannels> mGains; // Per sample gains, long blocks are processed in chunks of this size
+public:
+	std::atomic<float> thresholdDb;
+	std::atomic<float> ratio;
+	std::atomic<float> attack;  //<! Seconds
+	std::atomic<float> release; //<! Seconds
+	std::atomic<float> makeupDb;
+
+	CompressorNode(float thresholdDb = -18.f, float ratio = 4.f, float attack = 0.005f, float release = 0.1f, float makeupDb = 0.f) noexcept :
+		thresholdDb(thresholdDb), ratio(ratio), attack(attack), release(release), makeupDb(makeupDb)
+	{}
+	void        process(DspBlock block) noexcept override;
+	const char* name() const noexcept override { return "compressor"; }
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Dsp.cpp"
+#endif
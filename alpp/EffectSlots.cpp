@@ -0,0 +1,141 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "EffectSlots.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == EffectDesc =============================================
+// =============================================================
+
+ALPP_DECL void EffectDesc::apply(EffectView effect) const noexcept {
+	effect.type(type);
+	for(auto& p : params) {
+		if(p.isInt) effect.set(p.param, p.i);
+		else        effect.set(p.param, p.f);
+	}
+}
+
+// =============================================================
+// == EffectSlotManager =============================================
+// =============================================================
+
+ALPP_DECL size_t EffectSlotManager::KeyHash::operator()(Key const& key) const noexcept {
+	// FNV-1a
+	uint64_t h = 14695981039346656037ull;
+	auto mix = [&h](uint64_t v) {
+		for(int i = 0; i < 8; i++, v >>= 8) {
+			h ^= v & 0xFF;
+			h *= 1099511628211ull;
+		}
+	};
+	mix((uint64_t)key.type);
+	mix((uint64_t)key.slotGain);
+	for(auto& p : key.params) {
+		mix((uint64_t)p.first);
+		mix((uint64_t)p.second);
+	}
+	return (size_t)h;
+}
+
+ALPP_DECL EffectSlotManager::EffectSlotManager(float precision) noexcept :
+	mPrecision(precision)
+{}
+ALPP_DECL EffectSlotManager::~EffectSlotManager() noexcept {}
+
+ALPP_DECL int64_t EffectSlotManager::quantize(float f) const noexcept {
+	// Logarithmic buckets, so parameters with small and large ranges are treated alike
+	constexpr float kZero = 1e-5f;
+	if(std::abs(f) < kZero) return 0;
+	int64_t bucket = (int64_t)std::llround(std::log(std::abs(f) / kZero) / std::log1p(mPrecision)) + 1;
+	return f < 0 ? -bucket : bucket;
+}
+
+ALPP_DECL EffectSlotManager::Key EffectSlotManager::makeKey(EffectDesc const& desc) const {
+	Key key;
+	key.type     = desc.type;
+	key.slotGain = quantize(desc.slotGain);
+	key.params.reserve(desc.params.size());
+	for(auto& p : desc.params)
+		key.params.emplace_back(p.param, p.isInt ? (int64_t)p.i : quantize(p.f));
+	// Later sets of the same parameter win, like they would when applied
+	std::stable_sort(key.params.begin(), key.params.end(), [](auto& a, auto& b) { return a.first < b.first; });
+	auto last = std::unique(key.params.rbegin(), key.params.rend(), [](auto& a, auto& b) { return a.first == b.first; });
+	key.params.erase(key.params.begin(), last.base());
+	return key;
+}
+
+ALPP_DECL EffectSlotManager::SlotRef EffectSlotManager::acquire(EffectDesc const& desc) {
+	Key key = makeKey(desc);
+
+	auto iter = mEntries.find(key);
+	if(iter == mEntries.end()) {
+		auto entry = std::make_unique<Entry>();
+		entry->effect.gen();
+		desc.apply(entry->effect);
+		entry->slot.gen();
+		entry->slot.effect(entry->effect);
+		entry->slot.gain(desc.slotGain);
+
+		iter = mEntries.emplace(std::move(key), std::move(entry)).first;
+		iter->second->key = &iter->first;
+	}
+
+	Entry* entry = iter->second.get();
+	entry->references++;
+	return SlotRef(this, entry);
+}
+
+ALPP_DECL void EffectSlotManager::release(Entry* entry) noexcept {
+	if(--entry->references > 0) return;
+	auto iter = mEntries.find(*entry->key);
+	mEntries.erase(iter); // Deletes slot, then effect
+}
+
+// =============================================================
+// == EffectSlotManager::SlotRef =============================================
+// =============================================================
+
+ALPP_DECL EffectSlotManager::SlotRef::SlotRef(SlotRef&& other) noexcept :
+	mManager(std::exchange(other.mManager, nullptr)),
+	mEntry(std::exchange(other.mEntry, nullptr))
+{}
+ALPP_DECL EffectSlotManager::SlotRef& EffectSlotManager::SlotRef::operator=(SlotRef&& other) noexcept {
+	if(this != &other) {
+		reset();
+		mManager = std::exchange(other.mManager, nullptr);
+		mEntry   = std::exchange(other.mEntry, nullptr);
+	}
+	return *this;
+}
+ALPP_DECL EffectSlotManager::SlotRef::SlotRef(SlotRef const& other) noexcept :
+	mManager(other.mManager),
+	mEntry(other.mEntry)
+{
+	if(mEntry) mEntry->references++;
+}
+ALPP_DECL EffectSlotManager::SlotRef& EffectSlotManager::SlotRef::operator=(SlotRef const& other) noexcept {
+	if(other.mEntry) other.mEntry->references++;
+	reset();
+	mManager = other.mManager;
+	mEntry   = other.mEntry;
+	return *this;
+}
+ALPP_DECL void EffectSlotManager::SlotRef::reset() noexcept {
+	if(mEntry) mManager->release(mEntry);
+	mManager = nullptr;
+	mEntry   = nullptr;
+}
+
+} // namespace al
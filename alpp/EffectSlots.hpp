@@ -0,0 +1,105 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace al {
+
+// Effect type plus parameters, applied to an EffectView with apply()
+class EffectDesc {
+public:
+	struct Param {
+		int   param;
+		bool  isInt;
+		float f;
+		int   i;
+	};
+
+	EffectType         type;
+	float              slotGain = 1.f;
+	std::vector<Param> params;
+
+	EffectDesc(EffectType type = EffectNull) noexcept : type(type) {}
+
+	EffectDesc& set(int param, float f) { params.push_back({ param, false, f, 0 }); return *this; }
+	EffectDesc& set(int param, int   i) { params.push_back({ param, true, 0.f, i }); return *this; }
+
+	void apply(EffectView effect) const noexcept;
+};
+
+// Shares one AuxiliaryEffectsSlot between everyone asking for the same effect configuration.
+// Float parameters are compared after quantizing them to `precision` relative steps (2% by default), so a reverb with a decay time
+// of 1.49s and one of 1.5s end up in the same slot. The slot keeps the parameters of whoever requested it first.
+// Slots are reference counted and deleted as soon as the last SlotRef goes away. The manager has to outlive all SlotRefs.
+class EffectSlotManager {
+	struct Key {
+		EffectType type;
+		std::vector<std::pair<int, int64_t>> params; // Sorted by param
+		int64_t    slotGain;
+
+		bool operator==(Key const& other) const noexcept { return type == other.type && slotGain == other.slotGain && params == other.params; }
+	};
+	struct KeyHash {
+		size_t operator()(Key const& key) const noexcept;
+	};
+	struct Entry {
+		Effect               effect;
+		AuxiliaryEffectsSlot slot;
+		unsigned             references = 0;
+		Key const*           key        = nullptr; // Points into mEntries
+	};
+
+	float mPrecision;
+	std::unordered_map<Key, std::unique_ptr<Entry>, KeyHash> mEntries;
+public:
+	// A reference to a shared slot, releases it on destruction
+	class SlotRef {
+		friend class EffectSlotManager;
+
+		EffectSlotManager* mManager = nullptr;
+		Entry*             mEntry   = nullptr;
+
+		SlotRef(EffectSlotManager* manager, Entry* entry) noexcept : mManager(manager), mEntry(entry) {}
+	public:
+		SlotRef() noexcept = default;
+		~SlotRef() noexcept { reset(); }
+
+		SlotRef(SlotRef&& other) noexcept;
+		SlotRef& operator=(SlotRef&& other) noexcept;
+		SlotRef(SlotRef const& other) noexcept;
+		SlotRef& operator=(SlotRef const& other) noexcept;
+
+		void reset() noexcept;
+
+		AuxiliaryEffectsSlotView slot() const noexcept { return mEntry ? AuxiliaryEffectsSlotView((unsigned)mEntry->slot) : AuxiliaryEffectsSlotView(); }
+		operator AuxiliaryEffectsSlotView() const noexcept { return slot(); }
+		explicit operator bool() const noexcept { return mEntry != nullptr; }
+	};
+
+	explicit EffectSlotManager(float precision = 0.02f) noexcept;
+	~EffectSlotManager() noexcept;
+
+	EffectSlotManager(EffectSlotManager const&)            = delete;
+	EffectSlotManager& operator=(EffectSlotManager const&) = delete;
+
+	SlotRef acquire(EffectDesc const& desc);
+
+	size_t slotCount() const noexcept { return mEntries.size(); } //<! Number of distinct slots alive
+
+private:
+	Key     makeKey(EffectDesc const& desc) const;
+	int64_t quantize(float f) const noexcept;
+	void    release(Entry* entry) noexcept;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "EffectSlots.cpp"
+#endif
@@ -0,0 +1,111 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "FilterCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == FilterCache =============================================
+// =============================================================
+
+ALPP_DECL FilterCache::FilterCache(unsigned steps) noexcept :
+	mSteps(std::clamp(steps, 1u, 255u))
+{}
+ALPP_DECL FilterCache::~FilterCache() noexcept {}
+
+// Logarithmic buckets like EffectSlotManager::quantize, linear ones would round everything below 1/(2*steps) to a full cut
+ALPP_DECL unsigned FilterCache::bucket(float gain) const noexcept {
+	if(std::isnan(gain)) return mSteps;
+	if(gain <= 0)        return 0;
+	if(mSteps == 1)      return 1;
+	float db = 20.f * std::log10(std::min(gain, 1.f));
+	float t  = (std::max(db, FloorDb) - FloorDb) / -FloorDb;
+	return 1 + (unsigned)std::lround(t * (mSteps - 1));
+}
+ALPP_DECL float FilterCache::value(unsigned bucket) const noexcept {
+	if(bucket == 0)  return 0.f;
+	if(mSteps == 1) return 1.f;
+	float db = FloorDb - FloorDb * (float)(bucket - 1) / (mSteps - 1);
+	return std::pow(10.f, db / 20.f);
+}
+
+ALPP_DECL FilterCache::FilterRef FilterCache::lowpass (float gain, float gainhf)               { return acquire(Lowpass,  gain, gainhf, 1.f); }
+ALPP_DECL FilterCache::FilterRef FilterCache::highpass(float gain, float gainlf)               { return acquire(Highpass, gain, gainlf, 1.f); }
+ALPP_DECL FilterCache::FilterRef FilterCache::bandpass(float gain, float gainlf, float gainhf) { return acquire(Bandpass, gain, gainlf, gainhf); }
+
+ALPP_DECL FilterCache::FilterRef FilterCache::acquire(FilterType type, float a, float b, float c) {
+	unsigned ba = bucket(a), bb = bucket(b), bc = bucket(c);
+	uint32_t key = ((uint32_t)type << 24) | (ba << 16) | (bb << 8) | bc;
+
+	auto& slot = mEntries[key];
+	if(!slot) {
+		slot = std::make_unique<Entry>();
+		slot->key = key;
+
+		Filter& filter = slot->filter;
+		filter.gen();
+		filter.type(type);
+		switch(type) {
+			case Lowpass:  filter.lowpass_gain(value(ba));  filter.lowpass_gainhf(value(bb));  break;
+			case Highpass: filter.highpass_gain(value(ba)); filter.highpass_gainlf(value(bb)); break;
+			case Bandpass: filter.bandpass_gain(value(ba)); filter.bandpass_gainlf(value(bb)); filter.bandpass_gainhf(value(bc)); break;
+			default: break;
+		}
+	}
+
+	slot->references++;
+	return FilterRef(this, slot.get());
+}
+
+ALPP_DECL void FilterCache::release(Entry* entry) noexcept {
+	if(--entry->references > 0) return;
+	mEntries.erase(entry->key);
+}
+
+// =============================================================
+// == FilterCache::FilterRef =============================================
+// =============================================================
+
+ALPP_DECL FilterCache::FilterRef::FilterRef(FilterRef&& other) noexcept :
+	mCache(std::exchange(other.mCache, nullptr)),
+	mEntry(std::exchange(other.mEntry, nullptr))
+{}
+ALPP_DECL FilterCache::FilterRef& FilterCache::FilterRef::operator=(FilterRef&& other) noexcept {
+	if(this != &other) {
+		reset();
+		mCache = std::exchange(other.mCache, nullptr);
+		mEntry = std::exchange(other.mEntry, nullptr);
+	}
+	return *this;
+}
+ALPP_DECL FilterCache::FilterRef::FilterRef(FilterRef const& other) noexcept :
+	mCache(other.mCache),
+	mEntry(other.mEntry)
+{
+	if(mEntry) mEntry->references++;
+}
+ALPP_DECL FilterCache::FilterRef& FilterCache::FilterRef::operator=(FilterRef const& other) noexcept {
+	if(other.mEntry) other.mEntry->references++;
+	reset();
+	mCache = other.mCache;
+	mEntry = other.mEntry;
+	return *this;
+}
+ALPP_DECL void FilterCache::FilterRef::reset() noexcept {
+	if(mEntry) mCache->release(mEntry);
+	mCache = nullptr;
+	mEntry = nullptr;
+}
+
+} // namespace al
@@ -0,0 +1,80 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace al {
+
+// Shares filter objects between sources with (nearly) the same filter settings, e.g. all sources behind the same wall.
+// Gains are rounded to one of `steps` buckets spaced evenly in dB between -60dB and 0dB, and the filter is configured with
+// the rounded values, so every source in a bucket sounds the same no matter who created it. Gains <= 0 get their own
+// bucket (a full cut), gains above 1 are clamped to 1 and NaN is treated as 1 (unfiltered).
+// Filters are reference counted and deleted as soon as the last FilterRef goes away. The cache has to outlive all FilterRefs.
+class FilterCache {
+	struct Entry {
+		Filter   filter;
+		unsigned references = 0;
+		uint32_t key        = 0;
+	};
+
+	unsigned mSteps;
+	std::unordered_map<uint32_t, std::unique_ptr<Entry>> mEntries;
+public:
+	// A reference to a shared filter, releases it on destruction
+	class FilterRef {
+		friend class FilterCache;
+
+		FilterCache* mCache = nullptr;
+		Entry*       mEntry = nullptr;
+
+		FilterRef(FilterCache* cache, Entry* entry) noexcept : mCache(cache), mEntry(entry) {}
+	public:
+		FilterRef() noexcept = default;
+		~FilterRef() noexcept { reset(); }
+
+		FilterRef(FilterRef&& other) noexcept;
+		FilterRef& operator=(FilterRef&& other) noexcept;
+		FilterRef(FilterRef const& other) noexcept;
+		FilterRef& operator=(FilterRef const& other) noexcept;
+
+		void reset() noexcept;
+
+		FilterView filter() const noexcept { return mEntry ? FilterView((unsigned)mEntry->filter) : FilterView(); }
+		operator FilterView() const noexcept { return filter(); }
+		explicit operator bool() const noexcept { return mEntry != nullptr; }
+
+		bool operator==(FilterRef const& other) const noexcept { return mEntry == other.mEntry; } //<! Same shared filter
+		bool operator!=(FilterRef const& other) const noexcept { return mEntry != other.mEntry; }
+	};
+
+	static constexpr float FloorDb = -60.f; //<! Quietest non-zero bucket, lower gains are rounded up to it
+
+	explicit FilterCache(unsigned steps = 32) noexcept; //<! steps is clamped to [1, 255]
+	~FilterCache() noexcept;
+
+	FilterCache(FilterCache const&)            = delete;
+	FilterCache& operator=(FilterCache const&) = delete;
+
+	FilterRef lowpass (float gain, float gainhf);
+	FilterRef highpass(float gain, float gainlf);
+	FilterRef bandpass(float gain, float gainlf, float gainhf);
+
+	size_t filterCount() const noexcept { return mEntries.size(); } //<! Number of distinct filters alive
+
+private:
+	unsigned  bucket(float gain) const noexcept;
+	float     value(unsigned bucket) const noexcept;
+	FilterRef acquire(FilterType type, float a, float b, float c);
+	void      release(Entry* entry) noexcept;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "FilterCache.cpp"
+#endif
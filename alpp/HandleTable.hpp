@@ -0,0 +1,137 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace al {
+
+// A handle into a HandleTable. Unlike a raw SourceView/BufferView it knows when the object it refers to was destroyed,
+// even if OpenAL hands the same id out again.
+struct Handle {
+	uint32_t index      = 0;
+	uint32_t generation = 0; //<! 0 is never a valid generation, so a default constructed handle is always stale
+
+	bool operator==(Handle const& other) const noexcept { return index == other.index && generation == other.generation; }
+	bool operator!=(Handle const& other) const noexcept { return !(*this == other); }
+	explicit operator bool() const noexcept { return generation != 0; }
+};
+
+// Owns OpenAL objects (Source or Buffer) and hands out generational handles to them.
+// Checking a handle is an array lookup, no driver call.
+// Objects and any per-object Components are stored densely (structure of arrays) so they can be iterated directly:
+//   for(size_t i = 0; i < table.size(); i++) table.objects()[i].position(table.template components<0>()[i]);
+// Destroying an object moves the last one into its place, so dense indices are only stable until the next destroy().
+template<class Object, class... Components>
+class HandleTable {
+	struct Slot {
+		uint32_t dense;
+		uint32_t generation;
+	};
+
+	std::vector<Slot>     mSlots;
+	std::vector<uint32_t> mFreeSlots;
+
+	std::vector<Object>                    mObjects;
+	std::vector<uint32_t>                  mDenseToSlot;
+	std::tuple<std::vector<Components>...> mComponents;
+
+public:
+	HandleTable() noexcept = default;
+
+	HandleTable(HandleTable&&) noexcept            = default;
+	HandleTable& operator=(HandleTable&&) noexcept = default;
+	HandleTable(HandleTable const&)                = delete;
+	HandleTable& operator=(HandleTable const&)     = delete;
+
+	void reserve(size_t n) {
+		mSlots.reserve(n);
+		mObjects.reserve(n);
+		mDenseToSlot.reserve(n);
+		std::apply([n](auto&... columns) { (columns.reserve(n), ...); }, mComponents);
+	}
+
+	// Generates a new object
+	Handle create(Components... components) {
+		Object object;
+		object.gen();
+		return insert(std::move(object), std::move(components)...);
+	}
+	// Takes ownership of an existing object
+	Handle insert(Object&& object, Components... components) {
+		uint32_t slot;
+		if(!mFreeSlots.empty()) {
+			slot = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		}
+		else {
+			slot = (uint32_t)mSlots.size();
+			mSlots.push_back({ 0, 1 });
+		}
+
+		mSlots[slot].dense = (uint32_t)mObjects.size();
+		mObjects.push_back(std::move(object));
+		mDenseToSlot.push_back(slot);
+		pushComponents(std::index_sequence_for<Components...>(), std::move(components)...);
+
+		return { slot, mSlots[slot].generation };
+	}
+	// Destroys the object, all handles to it become stale. Does nothing if the handle already is stale.
+	void destroy(Handle h) noexcept {
+		if(!valid(h)) return;
+
+		uint32_t dense = mSlots[h.index].dense;
+		uint32_t last  = (uint32_t)mObjects.size() - 1;
+		if(dense != last) {
+			mObjects[dense]     = std::move(mObjects[last]);
+			mDenseToSlot[dense] = mDenseToSlot[last];
+			mSlots[mDenseToSlot[dense]].dense = dense;
+			std::apply([dense, last](auto&... columns) { ((columns[dense] = std::move(columns[last])), ...); }, mComponents);
+		}
+		mObjects.pop_back();
+		mDenseToSlot.pop_back();
+		std::apply([](auto&... columns) { (columns.pop_back(), ...); }, mComponents);
+
+		if(++mSlots[h.index].generation == 0) mSlots[h.index].generation = 1;
+		mFreeSlots.push_back(h.index);
+	}
+	void clear() noexcept {
+		while(!mObjects.empty())
+			destroy(handleAt(mObjects.size() - 1));
+	}
+
+	bool valid(Handle h) const noexcept { return h.index < mSlots.size() && mSlots[h.index].generation == h.generation; }
+
+	Object*       get(Handle h)       noexcept { return valid(h) ? &mObjects[mSlots[h.index].dense] : nullptr; } //<! nullptr if the handle is stale
+	Object const* get(Handle h) const noexcept { return valid(h) ? &mObjects[mSlots[h.index].dense] : nullptr; } //<! nullptr if the handle is stale
+
+	size_t indexOf(Handle h)    const noexcept { return mSlots[h.index].dense; } //<! Dense index of a valid handle
+	Handle handleAt(size_t dense) const noexcept { uint32_t slot = mDenseToSlot[dense]; return { slot, mSlots[slot].generation }; }
+
+	size_t size()  const noexcept { return mObjects.size(); }
+	bool   empty() const noexcept { return mObjects.empty(); }
+
+	Object*       objects()       noexcept { return mObjects.data(); }
+	Object const* objects() const noexcept { return mObjects.data(); }
+
+	template<size_t I> auto*       components()       noexcept { return std::get<I>(mComponents).data(); }
+	template<size_t I> auto const* components() const noexcept { return std::get<I>(mComponents).data(); }
+	template<size_t I> auto&       component(Handle h)       noexcept { return std::get<I>(mComponents)[indexOf(h)]; } //<! Handle must be valid
+	template<size_t I> auto const& component(Handle h) const noexcept { return std::get<I>(mComponents)[indexOf(h)]; } //<! Handle must be valid
+
+private:
+	template<size_t... I>
+	void pushComponents(std::index_sequence<I...>, Components&&... components) {
+		(std::get<I>(mComponents).push_back(std::move(components)), ...);
+	}
+};
+
+using SourceTable = HandleTable<Source>;
+using BufferTable = HandleTable<Buffer>;
+
+} // namespace al
@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Idle.hpp"
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == IdleGovernor =============================================
+// =============================================================
+
+ALPP_DECL IdleGovernor::IdleGovernor(DeviceView device, std::chrono::milliseconds silence) noexcept :
+	mDevice(device),
+	mSilence(silence),
+	mSupported(device && device.canPause()),
+	mLastActive(Clock::now()),
+	mPlayCount(PlayCount())
+{}
+
+ALPP_DECL IdleGovernor::~IdleGovernor() noexcept {
+	wake();
+}
+
+ALPP_DECL void IdleGovernor::wake() noexcept {
+	mLastActive = Clock::now();
+	if(!mPaused) return;
+
+	mDevice.resume();
+	mPaused = false;
+	mPausedTime += mLastActive - mPausedAt;
+}
+
+ALPP_DECL void IdleGovernor::update() noexcept {
+	if(!mSupported) return;
+
+	unsigned long long plays = PlayCount();
+	bool active = plays != mPlayCount || PlayerSounds() > 0;
+	mPlayCount = plays;
+
+	mQuery.update();
+	for(size_t i = 0; i < mQuery.size() && !active; i++)
+		active = mQuery.state(i) == SourceState::Playing;
+
+	if(active) {
+		wake();
+	}
+	else if(!mPaused && Clock::now() - mLastActive >= mSilence) {
+		mDevice.pause();
+		mPaused   = true;
+		mPausedAt = Clock::now();
+		mPauses++;
+	}
+}
+
+ALPP_DECL IdleGovernor::Clock::duration IdleGovernor::pausedTime() const noexcept {
+	return mPaused ? mPausedTime + (Clock::now() - mPausedAt) : mPausedTime;
+}
+
+} // namespace al
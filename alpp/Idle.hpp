@@ -0,0 +1,59 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+#include "SourceQuery.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace al {
+
+// Pauses the device (ALC_SOFT_pause_device) once nothing has played for `silence`, so menus, a paused game or an idle
+// dedicated server don't keep the mixer running. Playing means a watched source is playing, one of the library's players
+// (OneShotPool, SubRangePlayer, StreamSource) has a sound going (PlayerSounds()), or any source was started through
+// SourceView::play since the last update() (PlayCount()). An unwatched source played by hand only restarts the silence period,
+// watch it if it can play longer than that. update() resumes the device as soon as something plays again, play() and wake()
+// resume before starting the source so the first frames aren't lost.
+// Does nothing on devices without the extension and on loopback devices, which only mix in renderSamples anyway.
+// Call everything from the thread that plays the sources.
+class IdleGovernor {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit IdleGovernor(DeviceView device, std::chrono::milliseconds silence = std::chrono::seconds(2)) noexcept;
+	~IdleGovernor() noexcept; //<! Leaves the device running
+
+	IdleGovernor(IdleGovernor const&)            = delete;
+	IdleGovernor& operator=(IdleGovernor const&) = delete;
+
+	void watch(SourceView source) { mQuery.add(source); }
+	void unwatch(SourceView source) noexcept { mQuery.remove(source); }
+
+	void update() noexcept;            //<! Once per frame, polls the watched sources and the global play counters
+	void wake() noexcept;              //<! Resumes now and restarts the silence period, e.g. before playing sources that aren't watched
+	void play(SourceView source) noexcept { wake(); source.play(); }
+
+	bool            paused()     const noexcept { return mPaused; }
+	uint64_t        pauses()     const noexcept { return mPauses; }
+	Clock::duration pausedTime() const noexcept; //<! In total, including the current pause
+
+private:
+	DeviceView                mDevice;
+	std::chrono::milliseconds mSilence;
+	bool                      mSupported;
+	bool                      mPaused = false;
+	uint64_t                  mPauses = 0;
+	Clock::time_point         mLastActive;
+	Clock::time_point         mPausedAt;
+	Clock::duration           mPausedTime {};
+	unsigned long long        mPlayCount;
+	SourceStateQuery          mQuery { SourceStateQuery::State };
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Idle.cpp"
+#endif
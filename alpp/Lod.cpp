@@ -0,0 +1,76 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Lod.hpp"
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == LodPolicy =============================================
+// =============================================================
+
+ALPP_DECL void LodPolicy::resolve() noexcept {
+	if(highResampler < 0) highResampler = DefaultResampler();
+	if(lowResampler < 0) {
+		lowResampler = FindResampler("Linear");
+		if(lowResampler < 0) lowResampler = DefaultResampler();
+	}
+}
+
+ALPP_DECL LodLevel LodPolicy::choose(SourceCategory category, float distance, float gain, bool important, LodLevel current) const noexcept {
+	if(category != SourceCategory::World) return LodLevel::Direct;
+	if(important || distance <= nearDistance) return LodLevel::High;
+	if(distance >= farDistance || gain < quietGain) return LodLevel::Low;
+	return current == LodLevel::Low ? LodLevel::Low : LodLevel::High;
+}
+
+ALPP_DECL void LodPolicy::apply(SourceView source, LodLevel level) const noexcept {
+	if(highResampler < 0 || lowResampler < 0) {
+		LodPolicy resolved = *this;
+		resolved.resolve();
+		resolved.apply(source, level);
+		return;
+	}
+
+	switch(level) {
+		case LodLevel::High:
+			source.direct_channels(DirectChannels::Off);
+			source.spatialize(Spatialize::Auto);
+			source.resampler(highResampler);
+			break;
+		case LodLevel::Low:
+			source.direct_channels(DirectChannels::Off);
+			source.spatialize(lowSpatialize);
+			source.resampler(lowResampler);
+			break;
+		case LodLevel::Direct:
+			source.direct_channels(ExtensionPresent("AL_SOFT_direct_channels_remix") ? DirectChannels::RemixUnmatched : DirectChannels::DropUnmatched);
+			source.spatialize(Spatialize::Off);
+			source.resampler(highResampler);
+			break;
+		case LodLevel::Unset:
+			break;
+	}
+}
+
+// =============================================================
+// == SourceLod =============================================
+// =============================================================
+
+ALPP_DECL bool SourceLod::update(SourceView source, LodPolicy const& policy, SourceCategory category, float distance, float gain, bool important) noexcept {
+	LodLevel level = policy.choose(category, distance, gain, important, mLevel);
+	if(level == mLevel) return false;
+
+	policy.apply(source, level);
+	mLevel = level;
+	return true;
+}
+
+} // namespace al
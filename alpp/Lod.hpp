@@ -0,0 +1,61 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+
+#include <cstdint>
+
+namespace al {
+
+enum class SourceCategory : uint8_t {
+	World, //<! Positioned in the scene, subject to LOD
+	Music, //<! Played with direct channels, not spatialized
+	Ui,    //<! Played with direct channels, not spatialized
+};
+
+enum class LodLevel : uint8_t {
+	Unset,
+	High,   //<! Near or important: highResampler, the device's default unless set
+	Low,    //<! Far or quiet: cheap resampler
+	Direct, //<! Music and UI: direct channels (remixing unmatched ones if supported), no spatialization
+};
+
+// Rendering quality per source. Picking a level is pure math, applying it only touches AL when the level changes (see SourceLod).
+struct LodPolicy {
+	float nearDistance = 15.f;  //<! Closer than this is always High
+	float farDistance  = 40.f;  //<! Further than this is Low, unless important
+	float quietGain    = 0.05f; //<! Effective gain below this is Low, unless important
+
+	int highResampler = -1; //<! -1: the device's default
+	int lowResampler  = -1; //<! -1: "Linear" if available, else the default
+
+	// HRTF is a device setting in OpenAL Soft, the only way to skip it for a source is to not spatialize it at all, which also drops panning.
+	// Keep Auto unless losing the direction of far away sources is acceptable.
+	Spatialize lowSpatialize = Spatialize::Auto;
+
+	// Resolves the -1 resamplers, needs a current context. Without it apply() looks them up on every call.
+	void resolve() noexcept;
+
+	// distance to the listener and gain after attenuation; sources inside the hysteresis band between near and far keep their current level
+	LodLevel choose(SourceCategory category, float distance, float gain, bool important, LodLevel current = LodLevel::Unset) const noexcept;
+
+	void apply(SourceView source, LodLevel level) const noexcept;
+};
+
+// Remembers the level applied to one source, so updating every frame costs nothing unless the level changes
+class SourceLod {
+	LodLevel mLevel = LodLevel::Unset;
+public:
+	LodLevel level() const noexcept { return mLevel; }
+
+	// Returns true if the level changed (and AL was called)
+	bool update(SourceView source, LodPolicy const& policy, SourceCategory category, float distance, float gain, bool important = false) noexcept;
+	void reset() noexcept { mLevel = LodLevel::Unset; } //<! Call when the source is reused for something else
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Lod.cpp"
+#endif
@@ -0,0 +1,116 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "OneShot.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == OneShotPool =============================================
+// =============================================================
+
+ALPP_DECL OneShotPool::OneShotPool(size_t capacity) :
+	mSources(capacity),
+	mSends((unsigned)std::max(CurrentDevice().sends(), 1)),
+	mResampler(ExtensionPresent("AL_SOFT_source_resampler")),
+	mSpatialize(ExtensionPresent("AL_SOFT_source_spatialize")),
+	mDirect(ExtensionPresent("AL_SOFT_direct_channels"))
+{
+	Source::gen(mSources.data(), mSources.size());
+	mPlaying.reserve(capacity); // playOneShot and update are noexcept, nothing may allocate there
+	mFree.reserve(capacity);
+	for(size_t i = capacity; i > 0; i--)
+		mFree.push_back((unsigned)i - 1);
+}
+ALPP_DECL OneShotPool::~OneShotPool() noexcept {
+	stopAll();
+}
+
+ALPP_DECL SourceView OneShotPool::playOneShot(BufferView buffer, glm::vec3 position, OneShotParams const& params) noexcept {
+	if(mFree.empty()) {
+		mDropped++;
+		return nullptr;
+	}
+	unsigned index = mFree.back();
+	mFree.pop_back();
+	mPlaying.add(mSources[index], index);
+	AddPlayerSounds(1);
+
+	// The rest was reset to the defaults when the source was recycled
+	Source& source = mSources[index];
+	source.buffer(buffer);
+	source.position(position);
+	source.relative(params.relative);
+	source.gain(params.gain);
+	source.pitch(params.pitch);
+	source.reference_distance(params.referenceDistance);
+	source.rolloff_factor(params.rolloffFactor);
+	source.direct_filter(params.directFilter);
+	source.auxiliary_send_filter(0, params.send, params.sendFilter);
+	source.play();
+	return source;
+}
+
+ALPP_DECL void OneShotPool::update() noexcept {
+	mPlaying.update();
+	for(SourceEvent event : mPlaying.changes())
+		if(event.change == SourceChange::Stopped)
+			release(event.source, event.tag);
+
+	// A successful play() leaves the source Playing or Stopped. One that is still Initial failed to start
+	// (e.g. its buffer was deleted) and would never report Stopped. Backwards, remove() moves the last entry into the gap.
+	for(size_t i = mPlaying.size(); i > 0; i--)
+		if(mPlaying.state(i - 1) == SourceState::Initial)
+			release(mPlaying.source(i - 1), mPlaying.tag(i - 1));
+}
+
+ALPP_DECL void OneShotPool::release(SourceView source, unsigned index) noexcept {
+	recycle(source);
+	mFree.push_back(index);
+	mPlaying.remove(source);
+	AddPlayerSounds(-1);
+}
+
+ALPP_DECL void OneShotPool::stopAll() noexcept {
+	for(size_t i = 0; i < mPlaying.size(); i++) {
+		SourceView source = mPlaying.source(i);
+		source.stop();
+		recycle(source);
+	}
+	mFree.clear();
+	for(size_t i = mSources.size(); i > 0; i--)
+		mFree.push_back((unsigned)i - 1);
+	AddPlayerSounds(-(long long)mPlaying.size());
+	mPlaying.clear();
+}
+
+// Whatever the caller might have changed through the returned view, except for what playOneShot sets every time
+ALPP_DECL void OneShotPool::recycle(SourceView source) noexcept {
+	source.buffer(nullptr); // Release the buffer so it can be deleted
+	source.looping(false);
+	source.velocity(glm::vec3(0.f));
+	source.direction(glm::vec3(0.f));
+	source.max_distance(std::numeric_limits<float>::max());
+	source.min_gain(0.f);
+	source.max_gain(1.f);
+	source.cone_inner_angle(360.f);
+	source.cone_outer_angle(360.f);
+	source.cone_outer_gain(0.f);
+	for(unsigned send = 1; send < mSends; send++)
+		source.auxiliary_send_filter(send, {});
+	if(mResampler)  source.resampler(DefaultResampler());
+	if(mSpatialize) source.spatialize(Spatialize::Auto);
+	if(mDirect)     source.direct_channels(DirectChannels::Off);
+}
+
+} // namespace al
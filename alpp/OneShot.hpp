@@ -0,0 +1,62 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "SourceQuery.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace al {
+
+struct OneShotParams {
+	float gain              = 1.f;
+	float pitch             = 1.f;
+	float referenceDistance = 1.f;
+	float rolloffFactor     = 1.f;
+	bool  relative          = false; //<! Position is relative to the listener, e.g. for UI sounds
+
+	FilterView               directFilter; //<! e.g. from a FilterCache
+	AuxiliaryEffectsSlotView send;         //<! e.g. from an EffectSlotManager, played on send 0
+	FilterView               sendFilter;
+};
+
+// Plays sounds nobody needs to hold on to. The sources are generated once up front and reused:
+// update() reads the state of the playing ones in one SourceStateQuery pass and puts finished ones back into the pool.
+class OneShotPool {
+	std::vector<Source>   mSources;
+	unsigned              mSends;      // Of the device, sends 1.. are reset on recycling
+	bool                  mResampler;  // AL_SOFT_source_resampler
+	bool                  mSpatialize; // AL_SOFT_source_spatialize
+	bool                  mDirect;     // AL_SOFT_direct_channels
+	std::vector<unsigned> mFree; // Indices into mSources
+	SourceStateQuery      mPlaying { SourceStateQuery::State }; // Tagged with the index
+	uint64_t              mDropped = 0;
+public:
+	explicit OneShotPool(size_t capacity = 32); //<! Needs a current context
+	~OneShotPool() noexcept;
+
+	OneShotPool(OneShotPool const&)            = delete;
+	OneShotPool& operator=(OneShotPool const&) = delete;
+
+	// Returns the source playing the sound, only valid until the next update() (don't keep it).
+	// Changing it is fine, the source is reset to the defaults when it's recycled. Null if all sources are busy.
+	SourceView playOneShot(BufferView buffer, glm::vec3 position, OneShotParams const& params = {}) noexcept;
+
+	void update() noexcept; //<! Recycles finished sources, call once per frame
+	void stopAll() noexcept;
+
+	size_t   playing()   const noexcept { return mPlaying.size(); }
+	size_t   available() const noexcept { return mFree.size(); }
+	uint64_t dropped()   const noexcept { return mDropped; } //<! Sounds that didn't play because the pool was exhausted
+
+private:
+	void release(SourceView source, unsigned index) noexcept; //<! Back into the pool
+	void recycle(SourceView source) noexcept;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "OneShot.cpp"
+#endif
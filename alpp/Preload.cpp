@@ -0,0 +1,137 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Preload.hpp"
+
+#include <algorithm>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == Preloader =============================================
+// =============================================================
+
+ALPP_DECL Preloader::Preloader(Context& context, Context::Options options, PreloadManifest manifest, unsigned decodeThreads, size_t batchSize, ThreadConfig decodeThread, ThreadConfig deviceThread) :
+	mContext(context),
+	mManifest(std::move(manifest)),
+	mBatchSize(std::max<size_t>(batchSize, 1)),
+	mStart(Clock::now())
+{
+	std::stable_partition(mManifest.mEntries.begin(), mManifest.mEntries.end(), [](auto& e) { return e.priority; });
+
+	mDeviceThread = std::thread([this, options = std::move(options), deviceThread = std::move(deviceThread)]() mutable { ApplyThreadConfig(deviceThread); deviceLoop(std::move(options)); });
+
+	decodeThreads = std::clamp<unsigned>(decodeThreads, 1, (unsigned)std::max<size_t>(mManifest.size(), 1));
+	for(unsigned i = 0; i < decodeThreads; i++)
+		mDecodeThreads.emplace_back([this, decodeThread, i]() { ApplyThreadConfig(decodeThread, (int)i); decodeLoop(); });
+}
+
+ALPP_DECL Preloader::~Preloader() noexcept {
+	for(auto& thread : mDecodeThreads)
+		thread.join();
+	mDeviceThread.join();
+}
+
+ALPP_DECL void Preloader::decodeLoop() noexcept {
+	while(true) {
+		size_t index = mNextDecode.fetch_add(1, std::memory_order_relaxed);
+		if(index >= mManifest.size()) return;
+
+		auto& entry = mManifest.mEntries[index];
+		Decoded decoded { entry.name, {} };
+		bool ok = entry.decode && entry.decode(decoded.audio);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(ok)
+			mQueue.push_back(std::move(decoded));
+		else
+			mFailed.fetch_add(1, std::memory_order_relaxed);
+		mDecoded.fetch_add(1, std::memory_order_relaxed);
+		mChanged.notify_all();
+	}
+}
+
+ALPP_DECL void Preloader::deviceLoop(Context::Options options) noexcept {
+	mContext.init(std::move(options));
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mContextReady  = true;
+	mContextFailed = !mContext;
+	mTimings.contextReady = Clock::now() - mStart;
+	mChanged.notify_all();
+
+	std::vector<Decoded> batch;
+	std::vector<Buffer>  buffers;
+	while(!mContextFailed) {
+		mChanged.wait(lock, [this]() { return !mQueue.empty() || mDecoded.load(std::memory_order_relaxed) == mManifest.size(); });
+		if(mQueue.empty()) break; // Everything decoded and uploaded
+
+		// Take whatever is there, up to one batch, and upload it without holding the lock
+		while(!mQueue.empty() && batch.size() < mBatchSize) {
+			batch.push_back(std::move(mQueue.front()));
+			mQueue.pop_front();
+		}
+		lock.unlock();
+
+		buffers.resize(batch.size());
+		Buffer::gen(buffers.data(), buffers.size());
+		for(size_t i = 0; i < batch.size(); i++) {
+			auto& audio = batch[i].audio;
+			buffers[i].data(audio.data.data(), audio.data.size(), audio.format, audio.frequency);
+		}
+
+		lock.lock();
+		for(size_t i = 0; i < batch.size(); i++)
+			mBuffers[std::move(batch[i].name)] = std::move(buffers[i]);
+		if(mUploaded.load(std::memory_order_relaxed) == 0)
+			mTimings.firstSound = Clock::now() - mStart;
+		mUploaded.fetch_add(batch.size(), std::memory_order_relaxed);
+		batch.clear();
+		buffers.clear();
+		mChanged.notify_all();
+	}
+
+	if(mContextFailed) {
+		// Nothing can be uploaded, count everything once the decoders are done with their fetch_adds
+		mChanged.wait(lock, [this]() { return mDecoded.load(std::memory_order_relaxed) == mManifest.size(); });
+		mFailed.store(mManifest.size() - mUploaded.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+	mTimings.complete = Clock::now() - mStart;
+	mDone.store(true, std::memory_order_release);
+	mChanged.notify_all();
+}
+
+ALPP_DECL bool Preloader::waitForContext() noexcept {
+	std::unique_lock<std::mutex> lock(mMutex);
+	mChanged.wait(lock, [this]() { return mContextReady; });
+	return !mContextFailed;
+}
+ALPP_DECL void Preloader::wait() noexcept {
+	std::unique_lock<std::mutex> lock(mMutex);
+	mChanged.wait(lock, [this]() { return mDone.load(std::memory_order_relaxed); });
+}
+
+ALPP_DECL BufferView Preloader::find(const std::string& name) const noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto iter = mBuffers.find(name);
+	return iter == mBuffers.end() ? BufferView() : BufferView((unsigned)iter->second);
+}
+
+ALPP_DECL std::unordered_map<std::string, Buffer> Preloader::takeBuffers() noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return std::move(mBuffers);
+}
+
+ALPP_DECL Preloader::Timings Preloader::timings() const noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mTimings;
+}
+
+} // namespace al
@@ -0,0 +1,116 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+#include "Thread.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace al {
+
+struct DecodedAudio {
+	std::vector<uint8_t> data;
+	Format               format    = Format::Mono16;
+	unsigned             frequency = 0;
+};
+
+// Decodes one asset into `out`, returns false on failure. Called on a worker thread.
+using DecodeFunction = std::function<bool(DecodedAudio& out)>;
+
+// The sounds that have to be loaded at startup
+class PreloadManifest {
+	friend class Preloader;
+
+	struct Entry {
+		std::string    name;
+		DecodeFunction decode;
+		bool           priority;
+	};
+	std::vector<Entry> mEntries;
+public:
+	// Priority entries (e.g. the boot jingle) are decoded and uploaded before all others
+	void add(std::string name, DecodeFunction decode, bool priority = false) { mEntries.push_back({ std::move(name), std::move(decode), priority }); }
+
+	size_t size() const noexcept { return mEntries.size(); }
+};
+
+// Loads a PreloadManifest while the device is being opened:
+// - one thread opens the device, creates the context and then uploads decoded assets in batches
+// - `decodeThreads` workers decode assets in parallel, independent of the device
+// The context is made current once it exists, so don't touch `context` before waitForContext() returned.
+class Preloader {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Timings {
+		Clock::duration contextReady = Clock::duration::zero(); //<! Device opened and context current
+		Clock::duration firstSound   = Clock::duration::zero(); //<! First buffer uploaded and playable
+		Clock::duration complete     = Clock::duration::zero(); //<! Everything uploaded
+	};
+
+	Preloader(Context& context, Context::Options options, PreloadManifest manifest, unsigned decodeThreads = std::thread::hardware_concurrency(), size_t batchSize = 16,
+	          ThreadConfig decodeThread = { "alpp-decode" }, ThreadConfig deviceThread = { "alpp-preload" });
+	~Preloader() noexcept; //<! Waits for all threads
+
+	Preloader(Preloader const&)            = delete;
+	Preloader& operator=(Preloader const&) = delete;
+
+	bool waitForContext() noexcept; //<! Blocks until the context exists, false if it couldn't be created
+	void wait() noexcept;           //<! Blocks until everything is uploaded (or failed)
+	bool done() const noexcept { return mDone.load(std::memory_order_acquire); }
+
+	BufferView find(const std::string& name) const noexcept; //<! Null if not uploaded (yet)
+	size_t     uploaded() const noexcept { return mUploaded.load(std::memory_order_relaxed); }
+	size_t     failed()   const noexcept { return mFailed.load(std::memory_order_relaxed); }
+
+	std::unordered_map<std::string, Buffer> takeBuffers() noexcept; //<! Call after wait()
+	Timings timings() const noexcept;
+
+private:
+	struct Decoded {
+		std::string  name;
+		DecodedAudio audio;
+	};
+
+	Context&         mContext;
+	PreloadManifest  mManifest;
+	size_t           mBatchSize;
+	Clock::time_point mStart;
+
+	std::atomic<size_t> mNextDecode = 0;
+	std::atomic<size_t> mDecoded    = 0; // Successfully or not
+	std::atomic<size_t> mUploaded   = 0;
+	std::atomic<size_t> mFailed     = 0;
+	std::atomic<bool>   mDone       = false;
+
+	mutable std::mutex      mMutex;
+	std::condition_variable mChanged;
+	std::deque<Decoded>     mQueue;
+	bool                    mContextReady  = false;
+	bool                    mContextFailed = false;
+	Timings                 mTimings;
+	std::unordered_map<std::string, Buffer> mBuffers;
+
+	std::thread              mDeviceThread;
+	std::vector<std::thread> mDecodeThreads;
+
+	void decodeLoop() noexcept;
+	void deviceLoop(Context::Options options) noexcept;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Preload.cpp"
+#endif
@@ -0,0 +1,92 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+// Small SIMD helpers for block processing. SSE when available, scalar otherwise.
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define ALPP_SIMD_SSE2
+#endif
+
+namespace al::simd {
+
+// x[i] *= g
+inline void scale(float* x, size_t n, float g) noexcept {
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128 vg = _mm_set1_ps(g);
+	for(; i + 4 <= n; i += 4)
+		_mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), vg));
+#endif
+	for(; i < n; i++) x[i] *= g;
+}
+
+// x[i] *= g[i]
+inline void multiply(float* x, float const* g, size_t n) noexcept {
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	for(; i + 4 <= n; i += 4)
+		_mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(g + i)));
+#endif
+	for(; i < n; i++) x[i] *= g[i];
+}
+
+// x[i] += y[i] * g
+inline void accumulate(float* x, float const* y, size_t n, float g) noexcept {
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128 vg = _mm_set1_ps(g);
+	for(; i + 4 <= n; i += 4)
+		_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(y + i), vg)));
+#endif
+	for(; i < n; i++) x[i] += y[i] * g;
+}
+
+// x[i] = from + i * step
+inline void ramp(float* x, size_t n, float from, float step) noexcept {
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128 v  = _mm_add_ps(_mm_set1_ps(from), _mm_mul_ps(_mm_set_ps(3, 2, 1, 0), _mm_set1_ps(step)));
+	__m128 v4 = _mm_set1_ps(4 * step);
+	for(; i + 4 <= n; i += 4) {
+		_mm_storeu_ps(x + i, v);
+		v = _mm_add_ps(v, v4);
+	}
+#endif
+	for(; i < n; i++) x[i] = from + i * step;
+}
+
+// x[i] = round(x[i] * steps) / steps
+inline void quantize(float* x, size_t n, float steps) noexcept {
+	size_t i = 0;
+	float inv = 1.f / steps;
+#ifdef ALPP_SIMD_SSE2
+	__m128 vs = _mm_set1_ps(steps), vi = _mm_set1_ps(inv);
+	for(; i + 4 <= n; i += 4)
+		_mm_storeu_ps(x + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(x + i), vs))), vi));
+#endif
+	for(; i < n; i++) x[i] = std::nearbyint(x[i] * steps) * inv;
+}
+
+// Largest absolute value
+inline float peak(float const* x, size_t n) noexcept {
+	size_t i = 0;
+	float result = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 vmax = _mm_setzero_ps();
+	for(; i + 4 <= n; i += 4)
+		vmax = _mm_max_ps(vmax, _mm_and_ps(_mm_loadu_ps(x + i), mask));
+	float lanes[4];
+	_mm_storeu_ps(lanes, vmax);
+	result = std::fmax(std::fmax(lanes[0], lanes[1]), std::fmax(lanes[2], lanes[3]));
+#endif
+	for(; i < n; i++) result = std::fmax(result, std::fabs(x[i]));
+	return result;
+}
+
+} // namespace al::simd
@@ -0,0 +1,101 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "SourceQuery.hpp"
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == SourceStateQuery =============================================
+// =============================================================
+
+ALPP_DECL size_t SourceStateQuery::add(SourceView source, uint32_t tag) {
+	mSources.push_back(source);
+	mTags.push_back(tag);
+	mStates.push_back(SourceState::Initial);
+	mOffsets.push_back(0);
+	mProcessed.push_back(0);
+	return mSources.size() - 1;
+}
+
+ALPP_DECL void SourceStateQuery::remove(SourceView source) noexcept {
+	for(size_t i = 0; i < mSources.size(); i++) {
+		if((unsigned)mSources[i] != (unsigned)source) continue;
+
+		mSources[i]   = mSources.back();   mSources.pop_back();
+		mTags[i]      = mTags.back();      mTags.pop_back();
+		mStates[i]    = mStates.back();    mStates.pop_back();
+		mOffsets[i]   = mOffsets.back();   mOffsets.pop_back();
+		mProcessed[i] = mProcessed.back(); mProcessed.pop_back();
+		return;
+	}
+}
+
+ALPP_DECL void SourceStateQuery::clear() noexcept {
+	mSources.clear();
+	mTags.clear();
+	mStates.clear();
+	mOffsets.clear();
+	mProcessed.clear();
+	mChanges.clear();
+}
+
+// AL_BUFFERS_PROCESSED drops by the unqueued count. Without this, unqueueing k buffers while k more are processed
+// between two updates looks like no change at all.
+ALPP_DECL void SourceStateQuery::unqueued(SourceView source, unsigned count) noexcept {
+	for(size_t i = 0; i < mSources.size(); i++) {
+		if((unsigned)mSources[i] != (unsigned)source) continue;
+		mProcessed[i] = mProcessed[i] > count ? mProcessed[i] - count : 0;
+		return;
+	}
+}
+
+ALPP_DECL void SourceStateQuery::reserve(size_t sources) {
+	mSources.reserve(sources);
+	mTags.reserve(sources);
+	mStates.reserve(sources);
+	mOffsets.reserve(sources);
+	mProcessed.reserve(sources);
+	mChanges.reserve(sources * 2); // A state change and a BufferConsumed per source at most
+}
+
+ALPP_DECL void SourceStateQuery::update() noexcept {
+	mChanges.clear();
+	size_t count = mSources.size();
+
+	// All fields of a source back to back, so its state, offset and processed count belong together.
+	// The suspended context makes the whole pass one snapshot where the implementation supports it (OpenAL Soft doesn't).
+	SuspendedContext suspended;
+	for(size_t i = 0; i < count; i++) {
+		SourceView source = mSources[i];
+		if(mFields & State) {
+			SourceState previous = mStates[i];
+			SourceState current  = source.state();
+			mStates[i] = current;
+			if(current != previous) {
+				if(current == SourceState::Playing)      mChanges.push_back({ source, mTags[i], SourceChange::Started, 0 });
+				else if(current == SourceState::Paused)  mChanges.push_back({ source, mTags[i], SourceChange::Paused, 0 });
+				else if(current == SourceState::Stopped) mChanges.push_back({ source, mTags[i], SourceChange::Stopped, 0 });
+			}
+		}
+		if(mFields & SampleOffset)
+			mOffsets[i] = source.sample_offset();
+		if(mFields & BuffersProcessed) {
+			unsigned previous = mProcessed[i];
+			unsigned current  = source.buffers_processed();
+			mProcessed[i] = current;
+			// A drop means buffers were unqueued in between without unqueued(), the best guess is that everything processed now is new
+			unsigned consumed = current >= previous ? current - previous : current;
+			if(consumed > 0) mChanges.push_back({ source, mTags[i], SourceChange::BufferConsumed, consumed });
+		}
+	}
+}
+
+} // namespace al
@@ -0,0 +1,73 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace al {
+
+enum class SourceChange : uint8_t {
+	Started,
+	Paused,
+	Stopped,        //<! Finished or stopped, from any other state
+	BufferConsumed, //<! More queued buffers were processed, see SourceEvent::count. Only exact if unqueueing is reported with unqueued()
+};
+
+struct SourceEvent {
+	SourceView   source;
+	uint32_t     tag;   //<! As passed to SourceStateQuery::add
+	SourceChange change;
+	unsigned     count; //<! Newly processed buffers for BufferConsumed
+};
+
+// Reads the state of many sources in a single pass once per frame, so the rest of the frame works on the stored values
+// instead of asking the driver again. OpenAL has no call returning several sources at once, so the pass still makes one
+// call per source and field, but back to back, only for the requested fields and nowhere else. The pass runs inside a
+// SuspendedContext, one snapshot on implementations that honour alcSuspendContext (OpenAL Soft ignores it).
+class SourceStateQuery {
+public:
+	enum Field : unsigned {
+		State            = 1 << 0,
+		SampleOffset     = 1 << 1,
+		BuffersProcessed = 1 << 2,
+		All              = State | SampleOffset | BuffersProcessed,
+	};
+
+	explicit SourceStateQuery(unsigned fields = All) noexcept : mFields(fields) {}
+
+	size_t add(SourceView source, uint32_t tag = 0); //<! Returns the index, which stays valid until the next remove()
+	void   remove(SourceView source) noexcept;       //<! The last source takes the removed one's index
+	void   clear() noexcept;
+	void   unqueued(SourceView source, unsigned count) noexcept; //<! Report buffers unqueued from the source, so BufferConsumed counts stay exact
+	void   reserve(size_t sources); //<! Afterwards add() doesn't allocate (and can't throw) until more sources are added
+
+	void update() noexcept; //<! Queries all sources and fills changes()
+
+	size_t      size()                    const noexcept { return mSources.size(); }
+	SourceView  source(size_t i)           const noexcept { return mSources[i]; }
+	uint32_t    tag(size_t i)              const noexcept { return mTags[i]; }
+	SourceState state(size_t i)            const noexcept { return mStates[i]; }
+	size_t      sampleOffset(size_t i)     const noexcept { return mOffsets[i]; }
+	unsigned    buffersProcessed(size_t i) const noexcept { return mProcessed[i]; }
+
+	std::vector<SourceEvent> const& changes() const noexcept { return mChanges; } //<! Of the last update()
+
+private:
+	unsigned mFields;
+
+	std::vector<SourceView>  mSources;
+	std::vector<uint32_t>    mTags;
+	std::vector<SourceState> mStates;
+	std::vector<size_t>      mOffsets;
+	std::vector<unsigned>    mProcessed;
+	std::vector<SourceEvent> mChanges;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "SourceQuery.cpp"
+#endif
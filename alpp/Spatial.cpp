@@ -0,0 +1,189 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Spatial.hpp"
+#include "Simd.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <limits>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+namespace detail {
+
+#ifdef ALPP_SIMD_SSE2
+// (float)(p[0..3] - origin), the subtraction in double precision
+ALPP_DECL __m128 RelativeToOrigin(double const* p, __m128d origin) noexcept {
+	__m128 lo = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p),     origin));
+	__m128 hi = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 2), origin));
+	return _mm_movelh_ps(lo, hi);
+}
+#endif
+
+} // namespace detail
+
+// =============================================================
+// == SpatialScene =============================================
+// =============================================================
+
+ALPP_DECL Handle SpatialScene::add(SourceView source, glm::dvec3 position) {
+	constexpr float unknown = std::numeric_limits<float>::quiet_NaN(); // Never equal, so the first update() submits
+
+	source.relative(true);
+	Handle emitter = mEmitters.insert(std::move(source));
+	mColumns.each([](auto& column) { column.push_back(0); }); // Zero velocity and direction, like a new source
+	size_t i = mEmitters.indexOf(emitter);
+	mColumns.x[i] = position.x;
+	mColumns.y[i] = position.y;
+	mColumns.z[i] = position.z;
+	mColumns.lastX[i] = mColumns.lastY[i] = mColumns.lastZ[i] = unknown;
+	return emitter;
+}
+
+ALPP_DECL void SpatialScene::remove(Handle emitter) noexcept {
+	if(!valid(emitter)) return;
+
+	// HandleTable moves the last emitter into the freed dense index, the columns follow
+	size_t i = mEmitters.indexOf(emitter);
+	mEmitters.destroy(emitter);
+	mColumns.each([i](auto& column) {
+		column[i] = column.back();
+		column.pop_back();
+	});
+}
+
+ALPP_DECL void SpatialScene::clear() noexcept {
+	mEmitters.clear();
+	mColumns.each([](auto& column) { column.clear(); });
+}
+
+ALPP_DECL void SpatialScene::position(Handle emitter, glm::dvec3 position) noexcept {
+	if(!valid(emitter)) return;
+	size_t i = mEmitters.indexOf(emitter);
+	mColumns.x[i] = position.x;
+	mColumns.y[i] = position.y;
+	mColumns.z[i] = position.z;
+}
+
+ALPP_DECL void SpatialScene::velocity(Handle emitter, glm::vec3 velocity) noexcept {
+	if(!valid(emitter)) return;
+	size_t i = mEmitters.indexOf(emitter);
+	mColumns.velX[i] = velocity.x;
+	mColumns.velY[i] = velocity.y;
+	mColumns.velZ[i] = velocity.z;
+}
+
+ALPP_DECL void SpatialScene::direction(Handle emitter, glm::vec3 direction) noexcept {
+	if(!valid(emitter)) return;
+	size_t i = mEmitters.indexOf(emitter);
+	mColumns.dirX[i] = direction.x;
+	mColumns.dirY[i] = direction.y;
+	mColumns.dirZ[i] = direction.z;
+}
+
+ALPP_DECL void SpatialScene::listener(glm::dvec3 position, glm::vec3 forward, glm::vec3 up, glm::vec3 velocity) noexcept {
+	mListener         = position;
+	mListenerVelocity = velocity;
+	forward = glm::normalize(forward);
+	mRight  = glm::normalize(glm::cross(forward, up));
+	mUp     = glm::cross(mRight, forward);
+	mBack   = -forward;
+}
+
+ALPP_DECL void SpatialScene::rebase(glm::dvec3 offset) noexcept {
+	Columns& c = mColumns;
+	for(size_t i = 0; i < c.x.size(); i++) {
+		c.x[i] -= offset.x;
+		c.y[i] -= offset.y;
+		c.z[i] -= offset.z;
+	}
+	mListener -= offset;
+}
+
+ALPP_DECL void SpatialScene::update() noexcept {
+	Columns&    c       = mColumns;
+	SourceView* sources = mEmitters.objects();
+	size_t      count   = mEmitters.size();
+
+	// relative = rotation * (world - listener), same for velocities, directions are only rotated
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128d lx = _mm_set1_pd(mListener.x), ly = _mm_set1_pd(mListener.y), lz = _mm_set1_pd(mListener.z);
+	__m128 rx = _mm_set1_ps(mRight.x), ry = _mm_set1_ps(mRight.y), rz = _mm_set1_ps(mRight.z);
+	__m128 ux = _mm_set1_ps(mUp.x),    uy = _mm_set1_ps(mUp.y),    uz = _mm_set1_ps(mUp.z);
+	__m128 bx = _mm_set1_ps(mBack.x),  by = _mm_set1_ps(mBack.y),  bz = _mm_set1_ps(mBack.z);
+	__m128 lvx = _mm_set1_ps(mListenerVelocity.x), lvy = _mm_set1_ps(mListenerVelocity.y), lvz = _mm_set1_ps(mListenerVelocity.z);
+	for(; i + 4 <= count; i += 4) {
+		__m128 dx = detail::RelativeToOrigin(&c.x[i], lx);
+		__m128 dy = detail::RelativeToOrigin(&c.y[i], ly);
+		__m128 dz = detail::RelativeToOrigin(&c.z[i], lz);
+		_mm_storeu_ps(&c.relX[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, rx), _mm_mul_ps(dy, ry)), _mm_mul_ps(dz, rz)));
+		_mm_storeu_ps(&c.relY[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, ux), _mm_mul_ps(dy, uy)), _mm_mul_ps(dz, uz)));
+		_mm_storeu_ps(&c.relZ[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, bx), _mm_mul_ps(dy, by)), _mm_mul_ps(dz, bz)));
+
+		__m128 vx = _mm_sub_ps(_mm_loadu_ps(&c.velX[i]), lvx);
+		__m128 vy = _mm_sub_ps(_mm_loadu_ps(&c.velY[i]), lvy);
+		__m128 vz = _mm_sub_ps(_mm_loadu_ps(&c.velZ[i]), lvz);
+		_mm_storeu_ps(&c.relVX[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, rx), _mm_mul_ps(vy, ry)), _mm_mul_ps(vz, rz)));
+		_mm_storeu_ps(&c.relVY[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, ux), _mm_mul_ps(vy, uy)), _mm_mul_ps(vz, uz)));
+		_mm_storeu_ps(&c.relVZ[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, bx), _mm_mul_ps(vy, by)), _mm_mul_ps(vz, bz)));
+
+		__m128 nx = _mm_loadu_ps(&c.dirX[i]), ny = _mm_loadu_ps(&c.dirY[i]), nz = _mm_loadu_ps(&c.dirZ[i]);
+		_mm_storeu_ps(&c.relDX[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, rx), _mm_mul_ps(ny, ry)), _mm_mul_ps(nz, rz)));
+		_mm_storeu_ps(&c.relDY[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, ux), _mm_mul_ps(ny, uy)), _mm_mul_ps(nz, uz)));
+		_mm_storeu_ps(&c.relDZ[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, bx), _mm_mul_ps(ny, by)), _mm_mul_ps(nz, bz)));
+	}
+#endif
+	for(; i < count; i++) {
+		glm::vec3 d((float)(c.x[i] - mListener.x), (float)(c.y[i] - mListener.y), (float)(c.z[i] - mListener.z));
+		c.relX[i] = glm::dot(d, mRight);
+		c.relY[i] = glm::dot(d, mUp);
+		c.relZ[i] = glm::dot(d, mBack);
+
+		glm::vec3 v = glm::vec3(c.velX[i], c.velY[i], c.velZ[i]) - mListenerVelocity;
+		c.relVX[i] = glm::dot(v, mRight);
+		c.relVY[i] = glm::dot(v, mUp);
+		c.relVZ[i] = glm::dot(v, mBack);
+
+		glm::vec3 n(c.dirX[i], c.dirY[i], c.dirZ[i]);
+		c.relDX[i] = glm::dot(n, mRight);
+		c.relDY[i] = glm::dot(n, mUp);
+		c.relDZ[i] = glm::dot(n, mBack);
+	}
+
+	mSubmitted = 0;
+	DeferredUpdates batch;
+	for(i = 0; i < count; i++) {
+		if(c.relX[i] != c.lastX[i] || c.relY[i] != c.lastY[i] || c.relZ[i] != c.lastZ[i]) {
+			sources[i].position(glm::vec3(c.relX[i], c.relY[i], c.relZ[i]));
+			c.lastX[i] = c.relX[i];
+			c.lastY[i] = c.relY[i];
+			c.lastZ[i] = c.relZ[i];
+			mSubmitted++;
+		}
+		if(c.relVX[i] != c.lastVX[i] || c.relVY[i] != c.lastVY[i] || c.relVZ[i] != c.lastVZ[i]) {
+			sources[i].velocity(glm::vec3(c.relVX[i], c.relVY[i], c.relVZ[i]));
+			c.lastVX[i] = c.relVX[i];
+			c.lastVY[i] = c.relVY[i];
+			c.lastVZ[i] = c.relVZ[i];
+			mSubmitted++;
+		}
+		if(c.relDX[i] != c.lastDX[i] || c.relDY[i] != c.lastDY[i] || c.relDZ[i] != c.lastDZ[i]) {
+			sources[i].direction(glm::vec3(c.relDX[i], c.relDY[i], c.relDZ[i]));
+			c.lastDX[i] = c.relDX[i];
+			c.lastDY[i] = c.relDY[i];
+			c.lastDZ[i] = c.relDZ[i];
+			mSubmitted++;
+		}
+	}
+}
+
+} // namespace al
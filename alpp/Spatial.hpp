@@ -0,0 +1,92 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+#include "HandleTable.hpp" // Handle
+
+#include <glm/vec3.hpp> // Also dvec3
+
+#include <vector>
+
+namespace al {
+
+// Keeps emitter and listener positions in double precision world space and hands OpenAL only listener relative
+// floats (sources are made `relative(true)`), so positions far from the origin don't lose precision. The difference to
+// the listener is taken in double precision, then converted and rotated into the listener frame with SIMD, for all
+// emitters in one pass. Since OpenAL never sees world coordinates, moving the world origin doesn't need any AL calls.
+//
+// OpenAL applies neither the listener position nor its orientation to relative sources, only sources added here are
+// affected by listener(). Listener::position/orientation are left alone for the sources that aren't.
+// For the same reason cone directions have to be set here, in world space, not on the sources, and the listener's velocity
+// has to be passed to listener(): it is subtracted from every emitter's velocity, so Listener::velocity must stay zero
+// while scene sources play.
+//
+// Emitters are referred to by generational handles, which stay valid until that emitter is removed, whoever else
+// removes theirs. Emitters are stored densely for the update pass, setters with a stale handle do nothing.
+class SpatialScene {
+public:
+	Handle add(SourceView source, glm::dvec3 position); //<! Makes the source relative
+	void   remove(Handle emitter) noexcept;             //<! Doesn't touch the source. Does nothing if the handle is stale.
+	void   clear() noexcept;                            //<! All handles become stale
+
+	bool valid(Handle emitter) const noexcept { return mEmitters.valid(emitter); }
+
+	// The getters expect a valid handle
+	void       position(Handle emitter, glm::dvec3 position) noexcept;
+	glm::dvec3 position(Handle emitter) const noexcept { size_t i = mEmitters.indexOf(emitter); return { mColumns.x[i], mColumns.y[i], mColumns.z[i] }; }
+	void       velocity(Handle emitter, glm::vec3 velocity) noexcept; //<! In world space, for Doppler. Relative to the listener() velocity once submitted.
+	glm::vec3  velocity(Handle emitter) const noexcept { size_t i = mEmitters.indexOf(emitter); return { mColumns.velX[i], mColumns.velY[i], mColumns.velZ[i] }; }
+	void       direction(Handle emitter, glm::vec3 direction) noexcept; //<! In world space, for cones. Zero (the default) is omnidirectional.
+	glm::vec3  direction(Handle emitter) const noexcept { size_t i = mEmitters.indexOf(emitter); return { mColumns.dirX[i], mColumns.dirY[i], mColumns.dirZ[i] }; }
+	SourceView source(Handle emitter)    const noexcept { auto source = mEmitters.get(emitter); return source ? *source : SourceView(); }
+	size_t     size()                    const noexcept { return mEmitters.size(); }
+
+	void listener(glm::dvec3 position, glm::vec3 forward, glm::vec3 up, glm::vec3 velocity = glm::vec3(0.f)) noexcept; //<! forward and up as for Listener::orientation
+	glm::dvec3 listenerPosition() const noexcept { return mListener; }
+
+	// Moves the world origin by `offset` (subtracts it from every stored position). Relative positions don't change, so no AL calls.
+	void rebase(glm::dvec3 offset) noexcept;
+
+	// Submits the listener relative positions, velocities and directions of all emitters that changed since the last update, in one deferred batch
+	void update() noexcept;
+
+	size_t submitted() const noexcept { return mSubmitted; } //<! Positions, velocities and directions sent by the last update()
+
+private:
+	// Everything but the source, as structure of arrays in the dense order of mEmitters
+	struct Columns {
+		std::vector<double> x, y, z;                // World positions
+		std::vector<float>  relX, relY, relZ;       // In the listener frame
+		std::vector<float>  lastX, lastY, lastZ;    // What OpenAL has
+		std::vector<float>  velX, velY, velZ;       // Same for velocities
+		std::vector<float>  relVX, relVY, relVZ;
+		std::vector<float>  lastVX, lastVY, lastVZ;
+		std::vector<float>  dirX, dirY, dirZ;       // And directions
+		std::vector<float>  relDX, relDY, relDZ;
+		std::vector<float>  lastDX, lastDY, lastDZ;
+
+		template<class F> void each(F&& f) {
+			for(auto* column : { &x, &y, &z }) f(*column);
+			for(auto* column : { &relX, &relY, &relZ, &lastX, &lastY, &lastZ, &velX, &velY, &velZ, &relVX, &relVY, &relVZ, &lastVX, &lastVY, &lastVZ,
+			                     &dirX, &dirY, &dirZ, &relDX, &relDY, &relDZ, &lastDX, &lastDY, &lastDZ })
+				f(*column);
+		}
+	};
+
+	HandleTable<SourceView> mEmitters; // Only the handles and dense order, the scene doesn't own the sources
+	Columns                 mColumns;
+
+	glm::dvec3 mListener { 0, 0, 0 };
+	glm::vec3  mListenerVelocity { 0, 0, 0 };
+	glm::vec3  mRight    { 1, 0, 0 };
+	glm::vec3  mUp       { 0, 1, 0 };
+	glm::vec3  mBack     { 0, 0, 1 }; // OpenAL looks down -Z
+	size_t     mSubmitted = 0;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Spatial.cpp"
+#endif
@@ -0,0 +1,132 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Stats.hpp"
+
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define ALPP_STATS_POSIX
+#endif
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == Stats =============================================
+// =============================================================
+
+ALPP_DECL StatsSnapshot Stats::snapshot() const noexcept {
+	StatsSnapshot s;
+	s.activeSources   = activeSources.load(std::memory_order_relaxed);
+	s.virtualSources  = virtualSources.load(std::memory_order_relaxed);
+	s.playingStreams  = playingStreams.load(std::memory_order_relaxed);
+	s.uploadedBytes   = uploadedBytes.load(std::memory_order_relaxed);
+	s.alCalls         = alCalls.load();
+	s.underruns       = underruns.load(std::memory_order_relaxed);
+	s.eventQueueDepth = eventQueueDepth.load(std::memory_order_relaxed);
+	s.mixerLatencyNs  = mixerLatencyNs.load(std::memory_order_relaxed);
+	return s;
+}
+
+ALPP_DECL void Stats::sampleLatency(DeviceView device) noexcept {
+	if(device) mixerLatencyNs.store(device.latency(), std::memory_order_relaxed);
+}
+
+ALPP_DECL std::string FormatPrometheus(StatsSnapshot const& s, double alCallsPerSecond) {
+	std::string result;
+	char line[256];
+	auto metric = [&](const char* name, const char* type, const char* help, double value) {
+		snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n%s %.17g\n", name, help, name, type, name, value);
+		result += line;
+	};
+	metric("alpp_active_sources",            "gauge",   "Sources currently generated",                  (double)s.activeSources);
+	metric("alpp_virtual_sources",           "gauge",   "Sounds playing without a source",              (double)s.virtualSources);
+	metric("alpp_playing_streams",           "gauge",   "Streams currently playing",                    (double)s.playingStreams);
+	metric("alpp_uploaded_bytes_total",      "counter", "Bytes uploaded to buffers",                    (double)s.uploadedBytes);
+	metric("alpp_al_calls_total",            "counter", "AL calls made through the wrapper",            (double)s.alCalls);
+	metric("alpp_al_calls_per_second",       "gauge",   "AL calls per second since the previous export", alCallsPerSecond);
+	metric("alpp_underruns_total",           "counter", "Streams that ran out of data",                 (double)s.underruns);
+	metric("alpp_event_queue_depth",         "gauge",   "Pending entries in the event queue",           (double)s.eventQueueDepth);
+	metric("alpp_mixer_latency_seconds",     "gauge",   "Output latency of the device",                 s.mixerLatencyNs * 1e-9);
+	return result;
+}
+
+// =============================================================
+// == StatsExporter =============================================
+// =============================================================
+
+ALPP_DECL StatsExporter::StatsExporter(std::string path, std::chrono::milliseconds interval, DeviceView latencyDevice, ThreadConfig thread) :
+	mPath(std::move(path)),
+	mInterval(interval),
+	mDevice(latencyDevice)
+{
+	mThread = std::thread([this, thread = std::move(thread)]() { ApplyThreadConfig(thread); run(); });
+}
+ALPP_DECL StatsExporter::~StatsExporter() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWake.notify_all();
+	mThread.join();
+}
+
+ALPP_DECL bool StatsExporter::write(const char* path, std::string const& text) noexcept {
+#ifdef ALPP_STATS_POSIX
+	struct stat info;
+	if(stat(path, &info) == 0 && S_ISFIFO(info.st_mode)) {
+		int fd = open(path, O_WRONLY | O_NONBLOCK);
+		if(fd < 0) return false; // No reader
+		bool ok = ::write(fd, text.data(), text.size()) == (ssize_t)text.size();
+		::close(fd);
+		return ok;
+	}
+#endif
+
+	std::string tmp = std::string(path) + ".tmp";
+	FILE* file = fopen(tmp.c_str(), "wb");
+	if(!file) return false;
+	bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+	ok = fclose(file) == 0 && ok;
+	if(ok) {
+		#ifndef ALPP_STATS_POSIX
+		remove(path); // rename doesn't replace on windows
+		#endif
+		ok = rename(tmp.c_str(), path) == 0;
+	}
+	if(!ok) remove(tmp.c_str());
+	return ok;
+}
+
+ALPP_DECL void StatsExporter::run() noexcept {
+	using Clock = std::chrono::steady_clock;
+
+	auto     lastTime  = Clock::now();
+	uint64_t lastCalls = Stats::global().alCalls.load();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(!mWake.wait_for(lock, mInterval, [this]() { return mStop; })) {
+		if(mDevice) Stats::global().sampleLatency(mDevice);
+
+		StatsSnapshot snapshot = Stats::global().snapshot();
+		auto   now     = Clock::now();
+		double seconds = std::chrono::duration<double>(now - lastTime).count();
+		double rate    = seconds > 0 ? (snapshot.alCalls - lastCalls) / seconds : 0;
+		lastTime  = now;
+		lastCalls = snapshot.alCalls;
+
+		write(mPath.c_str(), FormatPrometheus(snapshot, rate));
+	}
+}
+
+} // namespace al
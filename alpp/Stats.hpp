@@ -0,0 +1,117 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace al {
+
+class DeviceView;
+
+struct StatsSnapshot {
+	int64_t  activeSources   = 0; //<! Sources that exist (Source::gen'd)
+	int64_t  virtualSources  = 0; //<! Sounds that logically play but have no source right now (maintained by the game)
+	int64_t  playingStreams  = 0;
+	uint64_t uploadedBytes   = 0; //<! Total passed to BufferView::data
+	uint64_t alCalls         = 0; //<! Total, see also StatsExporter for the rate
+	uint64_t underruns       = 0; //<! Streams that ran dry
+	int64_t  eventQueueDepth = 0;
+	int64_t  mixerLatencyNs  = 0; //<! Last value passed to Stats::sampleLatency
+};
+
+// Counter split into cache line sized shards. Each thread adds to the shard it was assigned on first use, so a counter bumped
+// by every AL call doesn't bounce one cache line between the threads making them. load() sums the shards.
+class ShardedCounter {
+	static constexpr unsigned Shards = 32;
+
+	struct alignas(64) Shard { std::atomic<uint64_t> value { 0 }; };
+	Shard mShards[Shards];
+
+	static unsigned ThisShard() noexcept {
+		static std::atomic<unsigned> next { 0 };
+		thread_local unsigned shard = next.fetch_add(1, std::memory_order_relaxed) % Shards;
+		return shard;
+	}
+public:
+	void     add(uint64_t n = 1) noexcept { mShards[ThisShard()].value.fetch_add(n, std::memory_order_relaxed); }
+	uint64_t load() const noexcept {
+		uint64_t sum = 0;
+		for(auto& shard : mShards) sum += shard.value.load(std::memory_order_relaxed);
+		return sum;
+	}
+};
+
+// Live counters, updated with relaxed atomics from inside the wrapper when compiled with ALPP_STATS
+// (AL calls are also counted with just ALPP_COUNT_CALLS). Without ALPP_STATS the wrapper doesn't touch them,
+// but they can still be updated by hand.
+class Stats {
+public:
+	std::atomic<int64_t>  activeSources   = 0;
+	std::atomic<int64_t>  virtualSources  = 0;
+	std::atomic<int64_t>  playingStreams  = 0;
+	std::atomic<uint64_t> uploadedBytes   = 0;
+	ShardedCounter        alCalls;
+	std::atomic<uint64_t> underruns       = 0;
+	std::atomic<int64_t>  eventQueueDepth = 0;
+	std::atomic<int64_t>  mixerLatencyNs  = 0;
+
+	static Stats& global() noexcept {
+		static Stats stats;
+		return stats;
+	}
+
+	// Reads every counter once with a relaxed load. The reads are independent: under concurrent updates the values can come
+	// from slightly different moments (e.g. activeSources from before a play and playingStreams from after), which is fine for
+	// monitoring but not for invariants between counters.
+	StatsSnapshot snapshot() const noexcept;
+
+	void sampleLatency(DeviceView device) noexcept; //<! Stores the device's current output latency (ALC_SOFT_device_clock)
+};
+
+} // namespace al
+
+// Included after Stats, AL.cpp updates the counters and is pulled in by AL.hpp with ALPP_INLINE
+#include "AL.hpp"
+#include "Thread.hpp"
+
+namespace al {
+
+// Prometheus text exposition format
+std::string FormatPrometheus(StatsSnapshot const& stats, double alCallsPerSecond);
+
+// Writes the global stats in Prometheus text format to `path` every `interval`, from its own thread.
+// Regular files are replaced atomically (write + rename) so a scraper never sees half a file.
+// A named pipe is written to directly, and skipped while nobody is reading it.
+class StatsExporter {
+	std::string               mPath;
+	std::chrono::milliseconds mInterval;
+	DeviceView                mDevice;
+
+	std::mutex              mMutex;
+	std::condition_variable mWake;
+	bool                    mStop = false;
+	std::thread             mThread;
+public:
+	StatsExporter(std::string path, std::chrono::milliseconds interval = std::chrono::seconds(1), DeviceView latencyDevice = nullptr, ThreadConfig thread = { "alpp-stats" });
+	~StatsExporter() noexcept;
+
+	StatsExporter(StatsExporter const&)            = delete;
+	StatsExporter& operator=(StatsExporter const&) = delete;
+
+	static bool write(const char* path, std::string const& text) noexcept; //<! One export, returns false if the file couldn't be written
+
+private:
+	void run() noexcept;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Stats.cpp"
+#endif
@@ -0,0 +1,213 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Stream.hpp"
+#include "Stats.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+#ifndef AL_STAT
+	#ifdef ALPP_STATS
+		#define AL_STAT(name, op, value) al::Stats::global().name.op(value, std::memory_order_relaxed)
+	#else
+		#define AL_STAT(name, op, value) ((void)0)
+	#endif
+#endif
+
+namespace al {
+
+ALPP_DECL StreamProducer::~StreamProducer() noexcept {}
+
+// =============================================================
+// == StreamSource =============================================
+// =============================================================
+
+ALPP_DECL StreamSource::StreamSource(std::unique_ptr<StreamProducer> producer, unsigned buffers, size_t chunkFrames) noexcept :
+	mProducer(std::move(producer)),
+	mFormat(mProducer->format()),
+	mFrameSize(std::max(FrameSize(mFormat.format), 1u))
+{
+	mSource.gen();
+	mBuffers.resize(std::max(buffers, 2u));
+	Buffer::gen(mBuffers.data(), mBuffers.size());
+	for(auto& buffer : mBuffers)
+		mFree.push_back(buffer);
+	mChunk.resize(std::max<size_t>(chunkFrames, 1) * mFrameSize);
+}
+
+ALPP_DECL StreamSource::~StreamSource() noexcept {
+	setPlaying(false);
+	mSource.destroy(); // Before the buffers, they're still queued
+}
+
+ALPP_DECL void StreamSource::setPlaying(bool playing) noexcept {
+	if(playing != mPlaying) {
+		AL_STAT(playingStreams, fetch_add, playing ? 1 : -1);
+		AddPlayerSounds(playing ? 1 : -1);
+	}
+	mPlaying = playing;
+}
+
+ALPP_DECL void StreamSource::submit(size_t bytes) noexcept {
+	BufferView buffer = mFree.back();
+	mFree.pop_back();
+	buffer.data(mChunk.data(), bytes, mFormat.format, mFormat.frequency);
+	mSource.queueBuffer(buffer);
+
+	// Keep a partial frame for the next chunk
+	memmove(mChunk.data(), mChunk.data() + bytes, mFill - bytes);
+	mFill -= bytes;
+}
+
+ALPP_DECL bool StreamSource::update() noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if(mFinished) return false;
+
+	for(unsigned n = mSource.buffers_processed(); n > 0; n--)
+		mFree.push_back(mSource.unqueueBuffer());
+	unsigned queued = (unsigned)(mBuffers.size() - mFree.size());
+
+	// Only read as much as fits into the free buffers
+	while(!mEnded && !mFree.empty()) {
+		size_t       written = 0;
+		StreamStatus status  = mProducer->read(mChunk.data() + mFill, mChunk.size() - mFill, written);
+		mFill += std::min(written, mChunk.size() - mFill);
+		if(status == StreamStatus::EndOfStream) mEnded = true;
+
+		size_t whole = mFill - mFill % mFrameSize;
+		bool   full  = mFill == mChunk.size();
+		if(whole > 0 && (full || mEnded || (queued == 0 && status == StreamStatus::Pending))) {
+			submit(whole);
+			queued++;
+			continue;
+		}
+		if(status != StreamStatus::Ready || written == 0) break;
+	}
+
+	if(mPlaying) {
+		SourceState state = mSource.state();
+		// Starved to Stopped, even if this update already has data to restart with. Running out after the end isn't an underrun.
+		if(state == SourceState::Stopped && mStarted && !mDry && (queued > 0 || !mEnded)) { // Producer didn't keep up
+			mDry = true;
+			mUnderruns++;
+			AL_STAT(underruns, fetch_add, 1);
+		}
+		if(state == SourceState::Initial || state == SourceState::Stopped) {
+			if(queued > 0) {
+				mSource.play();
+				mStarted = true;
+				mDry     = false;
+			}
+			else if(mEnded) {
+				mFinished = true;
+				setPlaying(false);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+ALPP_DECL void StreamSource::play() noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if(mFinished) return;
+	setPlaying(true);
+	if(mSource.paused()) mSource.play(); // Otherwise started by update() once there's data
+}
+ALPP_DECL void StreamSource::pause() noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	setPlaying(false);
+	mSource.pause();
+}
+ALPP_DECL void StreamSource::stop() noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	setPlaying(false);
+	mStarted = false;
+	mSource.stop();
+}
+
+ALPP_DECL bool StreamSource::finished() const noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mFinished;
+}
+ALPP_DECL uint64_t StreamSource::underruns() const noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mUnderruns;
+}
+
+// =============================================================
+// == StreamThread =============================================
+// =============================================================
+
+ALPP_DECL StreamThread::StreamThread(std::chrono::milliseconds interval, ThreadConfig thread) :
+	mInterval(interval)
+{
+	mThread = std::thread([this, thread = std::move(thread)]() { ApplyThreadConfig(thread); run(); });
+}
+ALPP_DECL StreamThread::~StreamThread() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWake.notify_all();
+	mThread.join();
+}
+
+ALPP_DECL void StreamThread::add(StreamSource& source) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mSources.push_back(&source);
+}
+ALPP_DECL void StreamThread::remove(StreamSource& source) noexcept {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mSources.erase(std::remove(mSources.begin(), mSources.end(), &source), mSources.end());
+}
+
+ALPP_DECL void StreamThread::run() noexcept {
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(!mWake.wait_for(lock, mInterval, [this]() { return mStop; })) {
+		for(StreamSource* source : mSources)
+			source->update();
+	}
+}
+
+// =============================================================
+// == PipeProducer =============================================
+// =============================================================
+
+#if defined(__unix__) || defined(__APPLE__)
+ALPP_DECL PipeProducer::PipeProducer(int fd, StreamFormat format) noexcept :
+	mFd(fd),
+	mFormat(format)
+{
+	int flags = fcntl(fd, F_GETFL);
+	if(flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+ALPP_DECL StreamStatus PipeProducer::read(void* out, size_t size, size_t& written) noexcept {
+	written = 0;
+	ssize_t n = ::read(mFd, out, size);
+	if(n > 0) {
+		written = (size_t)n;
+		return StreamStatus::Ready;
+	}
+	if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+		return StreamStatus::Pending;
+	return StreamStatus::EndOfStream; // Writer closed the pipe, or an error
+}
+#endif
+
+} // namespace al
@@ -0,0 +1,129 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "AL.hpp"
+#include "Thread.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace al {
+
+enum class StreamStatus {
+	Ready,       //<! Data was written
+	Pending,     //<! Nothing available right now, ask again later
+	EndOfStream, //<! Whatever was written is the last data
+};
+
+struct StreamFormat {
+	Format   format    = Format::Mono16;
+	unsigned frequency = 0;
+};
+
+// Source of audio data for a StreamSource: a decoder, a pipe, a synthesizer, ...
+// read() is called from the refill thread and must never block, return Pending instead.
+class StreamProducer {
+public:
+	virtual ~StreamProducer() noexcept;
+
+	virtual StreamFormat format() const noexcept = 0;
+
+	// Writes up to `size` bytes to `out` and stores how many in `written`. Writing less than asked for is fine,
+	// a partial frame is kept and completed by the next read.
+	virtual StreamStatus read(void* out, size_t size, size_t& written) noexcept = 0;
+};
+
+// Plays a StreamProducer through a queue of buffers. update() refills the queue from the producer:
+// - the producer is only asked for as much data as there are free buffers, so a fast producer is held back (backpressure)
+// - a slow producer is never waited for, a partially filled chunk is kept until the next update,
+//   or queued as is when the source would otherwise run dry
+// - if the source ran dry anyway it's counted as an underrun and restarted once data arrives
+// All methods are thread safe, update() is usually called by a StreamThread.
+class StreamSource {
+	std::unique_ptr<StreamProducer> mProducer;
+	StreamFormat mFormat;
+	unsigned     mFrameSize;
+
+	Source                  mSource;
+	std::vector<Buffer>     mBuffers;
+	std::vector<BufferView> mFree;
+	std::vector<uint8_t>    mChunk;
+	size_t                  mFill = 0; // Bytes in mChunk
+
+	mutable std::mutex mMutex;
+	bool     mPlaying   = false; // Wanted by the user
+	bool     mStarted   = false; // Source was played at least once since play()
+	bool     mDry       = false; // Current underrun was counted
+	bool     mEnded     = false; // Producer returned EndOfStream
+	bool     mFinished  = false; // ... and everything was played
+	uint64_t mUnderruns = 0;
+public:
+	StreamSource(std::unique_ptr<StreamProducer> producer, unsigned buffers = 4, size_t chunkFrames = 4096) noexcept;
+	~StreamSource() noexcept;
+
+	StreamSource(StreamSource const&)            = delete;
+	StreamSource& operator=(StreamSource const&) = delete;
+
+	bool update() noexcept; //<! Refills the queue, returns false once the stream finished
+
+	void play()  noexcept;
+	void pause() noexcept;
+	void stop()  noexcept; //<! Stops playback, the producer isn't rewound
+
+	bool     finished()  const noexcept;
+	uint64_t underruns() const noexcept;
+
+	SourceView      source()   const noexcept { return SourceView((unsigned)mSource); } //<! For gain, position, ...; don't queue buffers on it
+	StreamProducer& producer() const noexcept { return *mProducer; }
+
+private:
+	void submit(size_t bytes) noexcept;
+	void setPlaying(bool playing) noexcept;
+};
+
+// Calls update() on all added streams every `interval`
+class StreamThread {
+	std::chrono::milliseconds  mInterval;
+	std::mutex                 mMutex;
+	std::condition_variable    mWake;
+	std::vector<StreamSource*> mSources;
+	bool                       mStop = false;
+	std::thread                mThread;
+public:
+	explicit StreamThread(std::chrono::milliseconds interval = std::chrono::milliseconds(5), ThreadConfig thread = { "alpp-stream" });
+	~StreamThread() noexcept;
+
+	StreamThread(StreamThread const&)            = delete;
+	StreamThread& operator=(StreamThread const&) = delete;
+
+	void add(StreamSource& source);
+	void remove(StreamSource& source) noexcept; //<! After this returns, the source isn't touched anymore
+
+private:
+	void run() noexcept;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+// Reads from a pipe, socket or fifo, which is switched to non-blocking mode. Doesn't close the descriptor.
+class PipeProducer : public StreamProducer {
+	int          mFd;
+	StreamFormat mFormat;
+public:
+	PipeProducer(int fd, StreamFormat format) noexcept;
+
+	StreamFormat format() const noexcept override { return mFormat; }
+	StreamStatus read(void* out, size_t size, size_t& written) noexcept override;
+};
+#endif
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Stream.cpp"
+#endif
@@ -0,0 +1,61 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "SubRange.hpp"
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+// =============================================================
+// == SubRangePlayer =============================================
+// =============================================================
+
+ALPP_DECL SubRangePlayer::~SubRangePlayer() noexcept {
+	AddPlayerSounds(-(long long)mPlaying.size()); // Still playing, but nobody stops them at the end of their range anymore
+}
+
+ALPP_DECL void SubRangePlayer::play(SourceView source, SubRange const& range) noexcept {
+	stop(source);
+	source.looping(false);
+	source.buffer(range.buffer);
+	source.sample_offset(range.begin); // Applied when it starts playing
+	source.play();
+	mPlaying.add(source, (uint32_t)range.end);
+	AddPlayerSounds(1);
+}
+
+ALPP_DECL void SubRangePlayer::stop(SourceView source) noexcept {
+	for(size_t i = 0; i < mPlaying.size(); i++) {
+		if((unsigned)mPlaying.source(i) == (unsigned)source) {
+			source.stop();
+			mPlaying.remove(source);
+			AddPlayerSounds(-1);
+			return;
+		}
+	}
+}
+
+ALPP_DECL void SubRangePlayer::update() noexcept {
+	mPlaying.update();
+	for(size_t i = mPlaying.size(); i > 0; i--) { // Backwards, remove() moves the last source into the gap
+		SourceView  source = mPlaying.source(i - 1);
+		SourceState state  = mPlaying.state(i - 1);
+		bool done = state == SourceState::Stopped || state == SourceState::Initial;
+		if(!done && mPlaying.sampleOffset(i - 1) >= mPlaying.tag(i - 1)) {
+			source.stop();
+			done = true;
+		}
+		if(done) {
+			mPlaying.remove(source);
+			AddPlayerSounds(-1);
+		}
+	}
+}
+
+} // namespace al
@@ -0,0 +1,43 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "SourceQuery.hpp"
+
+namespace al {
+
+// Frames [begin, end) of a buffer
+struct SubRange {
+	BufferView buffer;
+	size_t     begin = 0;
+	size_t     end   = 0;
+
+	size_t frames() const noexcept { return end - begin; }
+};
+
+// Plays parts of a shared buffer: starts the source at the range's first frame and stops it once it got past the last one.
+// Stopping happens in update(), so a source overshoots by up to one update interval. Leave some silence after each range
+// that is followed by other audio. A range that ends the buffer doesn't overshoot, the source stops at the end by itself.
+// For an intro + loop piece no player is needed: set the buffer's loop points to the loop part and play it looping.
+class SubRangePlayer {
+	SourceStateQuery mPlaying { SourceStateQuery::State | SourceStateQuery::SampleOffset }; // Tagged with the end frame
+public:
+	SubRangePlayer() noexcept = default;
+	~SubRangePlayer() noexcept;
+
+	SubRangePlayer(SubRangePlayer const&)            = delete;
+	SubRangePlayer& operator=(SubRangePlayer const&) = delete;
+
+	void play(SourceView source, SubRange const& range) noexcept; //<! Replaces whatever the source played
+	void stop(SourceView source) noexcept;
+
+	void update() noexcept; //<! Stops sources that reached the end of their range, call at least once per frame
+
+	size_t playing() const noexcept { return mPlaying.size(); }
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "SubRange.cpp"
+#endif
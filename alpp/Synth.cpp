@@ -0,0 +1,304 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Synth.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+namespace detail {
+
+ALPP_DECL uint64_t PackParam(float value, float seconds) noexcept {
+	uint32_t v, s;
+	memcpy(&v, &value, 4);
+	memcpy(&s, &seconds, 4);
+	return (uint64_t)v << 32 | s;
+}
+ALPP_DECL void UnpackParam(uint64_t packed, float& value, float& seconds) noexcept {
+	uint32_t v = (uint32_t)(packed >> 32), s = (uint32_t)packed;
+	memcpy(&value, &v, 4);
+	memcpy(&seconds, &s, 4);
+}
+
+// Phase in [0, 1) to the waveform in [-1, 1]
+ALPP_DECL float Shape(Waveform waveform, float p) noexcept {
+	switch(waveform) {
+	case Waveform::Sine: {
+		// Parabolic approximation of sin(2 pi y), refined once. sin(2 pi p) = -sin(2 pi (p - 0.5))
+		float y = p - 0.5f;
+		float s = 8.f * y - 16.f * y * std::fabs(y);
+		s = 0.225f * (s * std::fabs(s) - s) + s;
+		return -s;
+	}
+	case Waveform::Triangle: return 1.f - 4.f * std::fabs(p - 0.5f);
+	case Waveform::Saw:      return 2.f * p - 1.f;
+	case Waveform::Square:   return p < 0.5f ? 1.f : -1.f;
+	}
+	return 0;
+}
+
+#ifdef ALPP_SIMD_SSE2
+ALPP_DECL __m128 Shape(Waveform waveform, __m128 p) noexcept {
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 one     = _mm_set1_ps(1.f);
+	const __m128 half    = _mm_set1_ps(0.5f);
+	switch(waveform) {
+	case Waveform::Sine: {
+		__m128 y = _mm_sub_ps(p, half);
+		__m128 s = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(8.f), y), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(16.f), y), _mm_and_ps(y, absMask)));
+		s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.225f), _mm_sub_ps(_mm_mul_ps(s, _mm_and_ps(s, absMask)), s)), s);
+		return _mm_sub_ps(_mm_setzero_ps(), s);
+	}
+	case Waveform::Triangle: return _mm_sub_ps(one, _mm_mul_ps(_mm_set1_ps(4.f), _mm_and_ps(_mm_sub_ps(p, half), absMask)));
+	case Waveform::Saw:      return _mm_sub_ps(_mm_add_ps(p, p), one);
+	case Waveform::Square: {
+		__m128 low = _mm_cmplt_ps(p, half);
+		return _mm_or_ps(_mm_and_ps(low, one), _mm_andnot_ps(low, _mm_set1_ps(-1.f)));
+	}
+	}
+	return _mm_setzero_ps();
+}
+#endif
+
+} // namespace detail
+
+// =============================================================
+// == SynthParam =============================================
+// =============================================================
+
+ALPP_DECL SynthParam::SynthParam(float value) noexcept :
+	mTarget(detail::PackParam(value, 0.f)),
+	mSeen(detail::PackParam(value, 0.f)),
+	mCurrent(value),
+	mGoal(value)
+{}
+
+ALPP_DECL void SynthParam::set(float value, float seconds) noexcept {
+	mTarget.store(detail::PackParam(value, std::max(seconds, 0.f)), std::memory_order_relaxed);
+}
+ALPP_DECL float SynthParam::target() const noexcept {
+	float value, seconds;
+	detail::UnpackParam(mTarget.load(std::memory_order_relaxed), value, seconds);
+	return value;
+}
+
+ALPP_DECL void SynthParam::next(size_t frames, unsigned frequency, float& from, float& to) noexcept {
+	uint64_t packed = mTarget.load(std::memory_order_relaxed);
+	if(packed != mSeen) {
+		float seconds;
+		mSeen = packed;
+		detail::UnpackParam(packed, mGoal, seconds);
+		mRemaining = std::max((size_t)(seconds * frequency), frames);
+		mStep      = (mGoal - mCurrent) / mRemaining;
+	}
+
+	from = mCurrent;
+	if(mRemaining > frames) {
+		mCurrent   += mStep * frames;
+		mRemaining -= frames;
+	}
+	else {
+		mCurrent   = mGoal;
+		mRemaining = 0;
+	}
+	to = mCurrent;
+}
+
+// =============================================================
+// == Generators =============================================
+// =============================================================
+
+ALPP_DECL void Oscillator::render(float* out, size_t frames, unsigned sampleRate) noexcept {
+	if(frames == 0) return;
+
+	float f0, f1, g0, g1;
+	frequency.next(frames, sampleRate, f0, f1);
+	gain.next(frames, sampleRate, g0, g1);
+	f0 = std::max(f0, 0.f);
+	f1 = std::max(f1, 0.f);
+
+	// With the frequency ramping linearly over the block, the phase of frame i is
+	// phase + i * inc + i * (i - 1) / 2 * dinc, so all frames can be computed independently
+	Waveform shape = waveform.load(std::memory_order_relaxed);
+	float    phase = (float)mPhase;
+	float    inc   = f0 / sampleRate;
+	float    dinc  = (f1 - f0) / sampleRate / frames;
+	float    dgain = (g1 - g0) / frames;
+
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128 vi = _mm_set_ps(3, 2, 1, 0);
+	for(; i + 4 <= frames; i += 4) {
+		__m128 p = _mm_add_ps(_mm_set1_ps(phase), _mm_mul_ps(vi, _mm_add_ps(_mm_set1_ps(inc), _mm_mul_ps(_mm_sub_ps(vi, _mm_set1_ps(1.f)), _mm_set1_ps(0.5f * dinc)))));
+		p = _mm_sub_ps(p, _mm_cvtepi32_ps(_mm_cvttps_epi32(p))); // Wrap, p >= 0
+		__m128 g = _mm_add_ps(_mm_set1_ps(g0), _mm_mul_ps(vi, _mm_set1_ps(dgain)));
+		_mm_storeu_ps(out + i, _mm_mul_ps(detail::Shape(shape, p), g));
+		vi = _mm_add_ps(vi, _mm_set1_ps(4.f));
+	}
+#endif
+	for(; i < frames; i++) {
+		float p = phase + i * (inc + (i - 1.f) * 0.5f * dinc);
+		p -= (float)(int)p;
+		out[i] = detail::Shape(shape, p) * (g0 + i * dgain);
+	}
+
+	double n = (double)frames;
+	mPhase += n * inc + n * (n - 1) * 0.5 * dinc;
+	mPhase -= std::floor(mPhase);
+}
+
+ALPP_DECL Noise::Noise(float cutoff, float gain, uint32_t seed) noexcept :
+	cutoff(cutoff),
+	gain(gain)
+{
+	for(auto& state : mState) {
+		seed = seed * 1664525u + 1013904223u;
+		state = seed | 1; // xorshift state must not be 0
+	}
+}
+
+ALPP_DECL void Noise::render(float* out, size_t frames, unsigned sampleRate) noexcept {
+	if(frames == 0) return;
+
+	// White noise from four interleaved xorshift32 generators, mapped to [-1, 1)
+	size_t i = 0;
+#ifdef ALPP_SIMD_SSE2
+	__m128i x = _mm_loadu_si128((__m128i const*)mState);
+	for(; i + 4 <= frames; i += 4) {
+		x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+		x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+		x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+		__m128 f = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(x, 9), _mm_set1_epi32(0x3F800000))); // [1, 2)
+		_mm_storeu_ps(out + i, _mm_sub_ps(_mm_add_ps(f, f), _mm_set1_ps(3.f)));
+	}
+	_mm_storeu_si128((__m128i*)mState, x);
+#endif
+	for(; i < frames; i++) {
+		uint32_t& x = mState[i & 3];
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		uint32_t bits = (x >> 9) | 0x3F800000;
+		float    f;
+		memcpy(&f, &bits, 4);
+		out[i] = 2.f * f - 3.f;
+	}
+
+	float c0, c1;
+	cutoff.next(frames, sampleRate, c0, c1);
+	if(c1 > 0) {
+		float a = 1.f - std::exp(-2.f * 3.14159265f * c1 / sampleRate);
+		for(i = 0; i < frames; i++)
+			out[i] = mLowpass += a * (out[i] - mLowpass);
+	}
+
+	float g0, g1;
+	gain.next(frames, sampleRate, g0, g1);
+	if(g0 == g1)
+		simd::scale(out, frames, g1);
+	else
+		for(i = 0; i < frames; i++) out[i] *= g0 + (g1 - g0) * i / frames;
+}
+
+// =============================================================
+// == Envelope =============================================
+// =============================================================
+
+ALPP_DECL void Envelope::render(float* out, size_t frames, unsigned sampleRate) noexcept {
+	bool gateOn = gate.load(std::memory_order_relaxed);
+	if(gateOn && !mGate)  mStage = Attack;
+	if(!gateOn && mGate && mStage != Idle) mStage = Release;
+	mGate = gateOn;
+
+	float level = sustain.load(std::memory_order_relaxed);
+	auto  step  = [sampleRate](float seconds, float distance) { return seconds * sampleRate > 1.f ? distance / (seconds * sampleRate) : distance; };
+	float up    = step(attack.load(std::memory_order_relaxed), 1.f);
+	float down  = step(decay.load(std::memory_order_relaxed), 1.f - level);
+	float fade  = step(release.load(std::memory_order_relaxed), 1.f);
+
+	for(size_t i = 0; i < frames; i++) {
+		switch(mStage) {
+		case Idle:    mLevel = 0; break;
+		case Attack:  if((mLevel += up) >= 1.f) { mLevel = 1.f; mStage = Decay; } break;
+		case Decay:   if((mLevel -= down) <= level) { mLevel = level; mStage = Sustain; } break;
+		case Sustain: mLevel = level; break;
+		case Release: if((mLevel -= fade) <= 0.f) { mLevel = 0.f; mStage = Idle; } break;
+		}
+		out[i] = mLevel;
+	}
+}
+
+// =============================================================
+// == Synth =============================================
+// =============================================================
+
+ALPP_DECL Synth::Synth(unsigned frequency, size_t blockFrames) :
+	mFrequency(frequency),
+	mBlockFrames(std::max<size_t>(blockFrames, 4)),
+	mScratch(mBlockFrames),
+	mGains(mBlockFrames),
+	gain(1.f)
+{}
+
+ALPP_DECL Oscillator& Synth::addOscillator(Waveform waveform, float frequency, float gain) {
+	return mOscillators.emplace_back(waveform, frequency, gain);
+}
+ALPP_DECL Noise& Synth::addNoise(float cutoff, float gain) {
+	return mNoises.emplace_back(cutoff, gain, 0x9E3779B9u * (uint32_t)(mNoises.size() + 1));
+}
+
+ALPP_DECL void Synth::renderBlock(float* out, size_t frames) noexcept {
+	std::fill(out, out + frames, 0.f);
+
+	float* scratch = mScratch.data();
+	for(auto& osc : mOscillators) {
+		osc.render(scratch, frames, mFrequency);
+		simd::accumulate(out, scratch, frames, 1.f);
+	}
+	for(auto& noise : mNoises) {
+		noise.render(scratch, frames, mFrequency);
+		simd::accumulate(out, scratch, frames, 1.f);
+	}
+
+	float g0, g1;
+	gain.next(frames, mFrequency, g0, g1);
+	simd::ramp(mGains.data(), frames, g0, (g1 - g0) / frames);
+	simd::multiply(out, mGains.data(), frames);
+
+	if(mUseEnvelope) {
+		mEnvelope.render(mGains.data(), frames, mFrequency);
+		simd::multiply(out, mGains.data(), frames);
+		mSounded |= !mEnvelope.idle();
+	}
+}
+
+ALPP_DECL void Synth::render(float* out, size_t frames) noexcept {
+	while(frames > 0) {
+		size_t n = std::min(frames, mBlockFrames);
+		renderBlock(out, n);
+		out    += n;
+		frames -= n;
+	}
+}
+
+ALPP_DECL StreamStatus Synth::read(void* out, size_t size, size_t& written) noexcept {
+	size_t frames = size / sizeof(float);
+	render(static_cast<float*>(out), frames);
+	written = frames * sizeof(float);
+
+	bool ended = endWhenReleased && mUseEnvelope && mSounded && mEnvelope.idle() && !mEnvelope.gate.load(std::memory_order_relaxed);
+	return ended ? StreamStatus::EndOfStream : StreamStatus::Ready;
+}
+
+} // namespace al
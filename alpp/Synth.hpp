@@ -0,0 +1,125 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include "Stream.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace al {
+
+// A parameter that can be changed from any thread while the synth renders. Changes are picked up once per block
+// and ramped linearly over `seconds` (at least one block, so a jump never clicks). Lock and allocation free.
+class SynthParam {
+	std::atomic<uint64_t> mTarget; // Value and ramp time packed together, so they always match
+
+	// Render thread only
+	uint64_t mSeen;
+	float    mCurrent;
+	float    mGoal;
+	float    mStep      = 0;
+	size_t   mRemaining = 0; // Frames
+public:
+	explicit SynthParam(float value = 0.f) noexcept;
+
+	void  set(float value, float seconds = 0.f) noexcept;
+	float target() const noexcept;
+
+	// Render thread: advances by one block of `frames`, returns the value at its start and end
+	void next(size_t frames, unsigned frequency, float& from, float& to) noexcept;
+};
+
+enum class Waveform { Sine, Triangle, Saw, Square };
+
+// Naive (not band limited) oscillator, fine for hums and tones in the lower range
+class Oscillator {
+	friend class Synth;
+	double mPhase = 0; // [0, 1)
+public:
+	std::atomic<Waveform> waveform;
+	SynthParam            frequency; //<! Hz
+	SynthParam            gain;
+
+	Oscillator(Waveform waveform, float frequency, float gain = 1.f) noexcept : waveform(waveform), frequency(frequency), gain(gain) {}
+
+	void render(float* out, size_t frames, unsigned sampleRate) noexcept; //<! Overwrites `out`
+};
+
+// White noise through a one-pole lowpass, e.g. for wind
+class Noise {
+	friend class Synth;
+	uint32_t mState[4];
+	float    mLowpass = 0;
+public:
+	SynthParam cutoff; //<! Hz, 0 for plain white noise
+	SynthParam gain;
+
+	explicit Noise(float cutoff = 0.f, float gain = 1.f, uint32_t seed = 0x9E3779B9) noexcept;
+
+	void render(float* out, size_t frames, unsigned sampleRate) noexcept; //<! Overwrites `out`
+};
+
+// Linear attack/decay/release, gated from any thread
+class Envelope {
+	friend class Synth;
+	enum Stage { Idle, Attack, Decay, Sustain, Release };
+
+	Stage mStage = Idle;
+	float mLevel = 0;
+	bool  mGate  = false;
+public:
+	std::atomic<float> attack;  //<! Seconds
+	std::atomic<float> decay;   //<! Seconds
+	std::atomic<float> sustain; //<! Level
+	std::atomic<float> release; //<! Seconds
+	std::atomic<bool>  gate;
+
+	Envelope(float attack = 0.01f, float decay = 0.1f, float sustain = 1.f, float release = 0.2f) noexcept :
+		attack(attack), decay(decay), sustain(sustain), release(release), gate(false)
+	{}
+
+	void render(float* out, size_t frames, unsigned sampleRate) noexcept; //<! Overwrites `out` with the envelope level
+	bool idle() const noexcept { return mStage == Idle; } //<! Render thread only
+};
+
+// Renders the sum of its oscillators and noise generators, shaped by an envelope, as mono float samples.
+// Works as a StreamProducer for a StreamSource, or can be rendered directly with render().
+// Add generators before rendering starts; afterwards only touch their parameters.
+class Synth : public StreamProducer {
+	unsigned mFrequency;
+	size_t   mBlockFrames;
+
+	std::deque<Oscillator> mOscillators; // Stable addresses
+	std::deque<Noise>      mNoises;
+	Envelope               mEnvelope;
+	bool                   mUseEnvelope = false;
+	bool                   mSounded     = false; // Envelope left Idle at some point
+
+	std::vector<float> mScratch, mGains; // mBlockFrames each, allocated once
+public:
+	SynthParam gain;
+	bool       endWhenReleased = false; //<! read() returns EndOfStream once the envelope was released and went silent
+
+	explicit Synth(unsigned frequency = 48000, size_t blockFrames = 256);
+
+	Oscillator& addOscillator(Waveform waveform, float frequency, float gain = 1.f);
+	Noise&      addNoise(float cutoff = 0.f, float gain = 1.f);
+	Envelope&   envelope() noexcept { mUseEnvelope = true; return mEnvelope; } //<! Without calling this the synth plays continuously
+
+	void render(float* out, size_t frames) noexcept;
+
+	StreamFormat format() const noexcept override { return { Format::MonoF32, mFrequency }; }
+	StreamStatus read(void* out, size_t size, size_t& written) noexcept override; //<! Never Pending
+
+private:
+	void renderBlock(float* out, size_t frames) noexcept;
+};
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Synth.cpp"
+#endif
@@ -0,0 +1,104 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#include "Thread.hpp"
+#include "AL.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <pthread.h>
+	#include <sched.h>
+	#define ALPP_THREAD_POSIX
+#endif
+
+#ifndef ALPP_DECL
+	#ifdef ALPP_INLINE
+		#define ALPP_DECL inline
+	#else
+		#define ALPP_DECL
+	#endif
+#endif
+
+namespace al {
+
+namespace detail {
+
+ALPP_DECL void ReportThreadConfig(const char* name, const char* what, int error) noexcept {
+	DebugLog& log = DebugLog::global();
+	if(DebugSeverity::Medium > log.minSeverity()) return;
+
+	DebugMessage m;
+	m.source   = DebugSource::ThirdParty;
+	m.type     = DebugType::Performance;
+	m.severity = DebugSeverity::Medium;
+	m.id       = 0;
+	snprintf(m.text, sizeof(m.text), "Thread '%s': couldn't set %s (error %d), running without", name, what, error);
+	log.push(m);
+}
+
+} // namespace detail
+
+ALPP_DECL unsigned ApplyThreadConfig(ThreadConfig const& config, int index) noexcept {
+	unsigned failed = 0;
+
+	char name[16] = "alpp"; // Linux limit including the terminator
+	if(!config.name.empty()) {
+		// The base name is cut, not the index, so the workers of a pool stay distinguishable
+		char suffix[16] = "";
+		if(index >= 0) snprintf(suffix, sizeof(suffix), "-%d", index);
+		size_t base = std::min(config.name.size(), sizeof(name) - 1 - strlen(suffix));
+		memcpy(name, config.name.data(), base);
+		memcpy(name + base, suffix, strlen(suffix) + 1);
+	}
+
+#if defined(ALPP_THREAD_POSIX)
+	if(!config.name.empty()) {
+	#if defined(__APPLE__)
+		int error = pthread_setname_np(name); // Only for the calling thread
+	#else
+		int error = pthread_setname_np(pthread_self(), name);
+	#endif
+		if(error) {
+			failed |= NameFailed;
+			detail::ReportThreadConfig(name, "the name", error);
+		}
+	}
+
+	if(config.policy != ThreadPolicy::Normal) {
+		int policy = config.policy == ThreadPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+		sched_param param {};
+		param.sched_priority = std::clamp(config.priority, sched_get_priority_min(policy), sched_get_priority_max(policy));
+		if(int error = pthread_setschedparam(pthread_self(), policy, &param)) { // EPERM without CAP_SYS_NICE/RLIMIT_RTPRIO
+			failed |= SchedulingFailed;
+			detail::ReportThreadConfig(name, "the real-time priority", error);
+		}
+	}
+
+	if(config.affinity != 0) {
+	#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for(int cpu = 0; cpu < 64; cpu++)
+			if(config.affinity & (uint64_t(1) << cpu)) CPU_SET(cpu, &set);
+		if(int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+			failed |= AffinityFailed;
+			detail::ReportThreadConfig(name, "the CPU affinity", error);
+		}
+	#else
+		failed |= AffinityFailed;
+		detail::ReportThreadConfig(name, "the CPU affinity", 0);
+	#endif
+	}
+#else
+	if(!config.name.empty())                  failed |= NameFailed;
+	if(config.policy != ThreadPolicy::Normal) failed |= SchedulingFailed;
+	if(config.affinity != 0)                  failed |= AffinityFailed;
+	if(failed) detail::ReportThreadConfig(name, "the thread configuration", 0);
+#endif
+
+	return failed;
+}
+
+} // namespace al
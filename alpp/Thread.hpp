@@ -0,0 +1,39 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found at the bottom of AL.hpp)
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace al {
+
+enum class ThreadPolicy {
+	Normal,     //<! Leaves the scheduling alone
+	Fifo,       //<! SCHED_FIFO
+	RoundRobin, //<! SCHED_RR
+};
+
+// Scheduling, CPU affinity and name for the threads the library starts (streaming, decoding, DSP, automation, stats).
+// Real-time policies usually need CAP_SYS_NICE or an RLIMIT_RTPRIO, whatever isn't permitted or supported on the
+// platform is skipped and reported to DebugLog::global(), the thread then runs with what could be applied.
+struct ThreadConfig {
+	std::string  name;               //<! Pools append the worker index. At most 15 characters on Linux including the index, longer names are cut.
+	ThreadPolicy policy   = ThreadPolicy::Normal;
+	int          priority = 0;       //<! For Fifo and RoundRobin, clamped to the range of the policy
+	uint64_t     affinity = 0;       //<! Bit i allows CPU i, 0 leaves the affinity alone (Linux only)
+};
+
+enum ThreadConfigFailure : unsigned {
+	NameFailed       = 1 << 0,
+	SchedulingFailed = 1 << 1,
+	AffinityFailed   = 1 << 2,
+};
+
+// Applies `config` to the calling thread, with `index` >= 0 appended to the name. Returns the ThreadConfigFailure bits of the parts that failed.
+unsigned ApplyThreadConfig(ThreadConfig const& config, int index = -1) noexcept;
+
+} // namespace al
+
+#if defined(ALPP_INLINE) || defined(ALPP_IMPLEMENTATION)
+#include "Thread.cpp"
+#endif
@@ -0,0 +1,115 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found in alpp/AL.hpp)
+
+// Accessor call overhead
+//
+// Sets position, velocity and gain of many sources per tick through SourceView, UncheckedSourceView and the raw AL
+// calls, and reports the cost per setter call. Build it twice, once with -DALPP_FAST_ACCESSORS (accessors from
+// alpp/AL.inl inlined at the call site) and once without (out-of-line calls into AL.cpp), and compare.
+//
+// Build: g++ -std=c++17 -O2 [-DALPP_FAST_ACCESSORS] [-DNDEBUG] -I. bench/accessor_inline.cpp alpp/AL.cpp -lopenal -pthread
+// Usage: accessor_inline [sources = 256] [ticks = 2000]
+
+#include <alpp/AL.hpp>
+
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr unsigned kFrequency = 48000;
+
+template<class View>
+double Run(std::vector<al::Source> const& sources, unsigned numTicks) {
+	std::vector<double> perCall;
+	perCall.reserve(numTicks);
+	for(unsigned tick = 0; tick < numTicks; tick++) {
+		float t = tick * 0.016f;
+		auto start = Clock::now();
+		for(size_t i = 0; i < sources.size(); i++) {
+			View source(sources[i]);
+			float a = t + i * 0.01f;
+			source.position(glm::vec3(std::cos(a) * 10.f, 0.f, std::sin(a) * 10.f));
+			source.velocity(glm::vec3(-std::sin(a), 0.f, std::cos(a)));
+			source.gain(0.5f + 0.5f * std::sin(a));
+		}
+		perCall.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (sources.size() * 3));
+	}
+	std::sort(perCall.begin(), perCall.end());
+	return perCall[perCall.size() / 2];
+}
+
+// What the accessors forward to, the lower bound
+double RunRaw(std::vector<al::Source> const& sources, unsigned numTicks) {
+	std::vector<double> perCall;
+	perCall.reserve(numTicks);
+	for(unsigned tick = 0; tick < numTicks; tick++) {
+		float t = tick * 0.016f;
+		auto start = Clock::now();
+		for(size_t i = 0; i < sources.size(); i++) {
+			unsigned handle = (unsigned)sources[i];
+			float a = t + i * 0.01f;
+			alSource3f(handle, AL_POSITION, std::cos(a) * 10.f, 0.f, std::sin(a) * 10.f);
+			alSource3f(handle, AL_VELOCITY, -std::sin(a), 0.f, std::cos(a));
+			alSourcef(handle, AL_GAIN, 0.5f + 0.5f * std::sin(a));
+		}
+		perCall.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (sources.size() * 3));
+	}
+	std::sort(perCall.begin(), perCall.end());
+	return perCall[perCall.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned numSources = argc > 1 ? (unsigned)atoi(argv[1]) : 256;
+	unsigned numTicks   = argc > 2 ? (unsigned)atoi(argv[2]) : 2000;
+
+	al::Device device = al::Device::OpenLoopback();
+	if(!device) {
+		fprintf(stderr, "Failed to open loopback device (ALC_SOFT_loopback missing?)\n");
+		return 1;
+	}
+
+	al::Context::Options options;
+	options.add({
+		ALC_FREQUENCY,           (int)kFrequency,
+		ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+		ALC_FORMAT_TYPE_SOFT,     ALC_FLOAT_SOFT,
+		ALC_MONO_SOURCES,         (int)numSources,
+	});
+	options.device = std::move(device);
+	al::Context context { std::move(options) };
+
+	std::vector<al::Source> sources(numSources);
+	al::Source::gen(sources.data(), sources.size());
+
+#ifdef ALPP_FAST_ACCESSORS
+	const char* mode = "inline (ALPP_FAST_ACCESSORS)";
+#else
+	const char* mode = "out of line";
+#endif
+#ifdef NDEBUG
+	const char* checks = "off";
+#else
+	const char* checks = "on";
+#endif
+
+	RunRaw(sources, numTicks / 10 + 1); // Warm up
+
+	printf("sources: %u, ticks: %u, accessors: %s, default error checks: %s\n", numSources, numTicks, mode, checks);
+	printf("ns per setter call (p50)\n");
+	printf("%-24s %12.1f\n", "raw AL",              RunRaw(sources, numTicks));
+	printf("%-24s %12.1f\n", "SourceView",          Run<al::SourceView>(sources, numTicks));
+	printf("%-24s %12.1f\n", "UncheckedSourceView", Run<al::UncheckedSourceView>(sources, numTicks));
+	printf("%-24s %12.1f\n", "CheckedSourceView",   Run<al::CheckedSourceView>(sources, numTicks));
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found in alpp/AL.hpp)
+
+// Large scene stress test
+//
+// Builds a synthetic scene of moving emitters (10000 by default), all playing, and drives per-frame updates through
+// SourceView::position/velocity and Listener::position/orientation like a game would.
+// Reports percentiles of the per-tick update cost, the mixing cost of the same tick and the number of AL calls per tick.
+//
+// Build: g++ -std=c++17 -O2 -DALPP_COUNT_CALLS -I. bench/scene_stress.cpp alpp/AL.cpp -lopenal -pthread
+// Usage: scene_stress [emitters = 10000] [ticks = 600]
+//
+// Without ALPP_COUNT_CALLS the AL call column reads 0.
+
+#include <alpp/AL.hpp>
+
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr unsigned kFrequency  = 48000;
+constexpr unsigned kTickRate   = 60;
+constexpr unsigned kTickFrames = kFrequency / kTickRate;
+
+struct Emitter {
+	glm::vec3 center;
+	float     radius;
+	float     speed; //<! Radians per second
+	float     phase;
+};
+
+struct Percentiles {
+	double p50, p90, p99, max;
+};
+
+Percentiles Summarize(std::vector<double> samples) {
+	if(samples.empty()) return {};
+	std::sort(samples.begin(), samples.end());
+	auto at = [&](double q) { return samples[std::min(samples.size() - 1, (size_t)(q * samples.size()))]; };
+	return { at(0.5), at(0.9), at(0.99), samples.back() };
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned numEmitters = argc > 1 ? (unsigned)atoi(argv[1]) : 10000;
+	unsigned numTicks    = argc > 2 ? (unsigned)atoi(argv[2]) : 600;
+	if(numTicks == 0) {
+		fprintf(stderr, "Need at least one tick\n");
+		return 1;
+	}
+
+	al::Device device = al::Device::OpenLoopback();
+	if(!device) {
+		fprintf(stderr, "Failed to open loopback device (ALC_SOFT_loopback missing?)\n");
+		return 1;
+	}
+
+	al::Context::Options options;
+	options.add({
+		ALC_FREQUENCY,           (int)kFrequency,
+		ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+		ALC_FORMAT_TYPE_SOFT,     ALC_FLOAT_SOFT,
+		ALC_MONO_SOURCES,         (int)numEmitters,
+	});
+	options.device = std::move(device);
+	al::Context context { std::move(options) };
+	al::DeviceView loopback = context.device();
+
+	// One second of low volume noise shared by all emitters
+	std::vector<int16_t> noise(kFrequency);
+	uint32_t seed = 1;
+	for(auto& s : noise) {
+		seed = seed * 1664525u + 1013904223u;
+		s = (int16_t)((int32_t)(seed >> 16) - 32768) / 64;
+	}
+	al::Buffer buffer { noise.data(), noise.size() * sizeof(int16_t), al::Format::Mono16, kFrequency };
+
+	std::vector<Emitter>    emitters(numEmitters);
+	std::vector<al::Source> sources(numEmitters);
+	for(unsigned i = 0; i < numEmitters; i++) {
+		float f = (float)i / numEmitters;
+		emitters[i] = {
+			glm::vec3(std::cos(f * 97.f) * 500.f, std::sin(f * 13.f) * 20.f, std::sin(f * 97.f) * 500.f),
+			5.f + 50.f * f,
+			0.5f + 3.f * std::fmod(f * 7.f, 1.f),
+			f * 6.2831853f
+		};
+		sources[i] = al::Source(buffer);
+		sources[i].looping(true);
+		sources[i].reference_distance(10.f);
+		sources[i].play();
+	}
+
+	std::vector<double> updateCost, mixCost;
+	std::vector<unsigned long long> callsPerTick;
+	updateCost.reserve(numTicks);
+	mixCost.reserve(numTicks);
+	callsPerTick.reserve(numTicks);
+
+	std::vector<float> mixBuffer(kTickFrames * 2);
+	for(unsigned tick = 0; tick < numTicks; tick++) {
+		float t = (float)tick / kTickRate;
+
+		auto calls = al::CallCount();
+		auto start = Clock::now();
+
+		glm::vec3 listenerPos(std::cos(t * 0.1f) * 100.f, 2.f, std::sin(t * 0.1f) * 100.f);
+		glm::vec3 forward(-std::sin(t * 0.1f), 0.f, std::cos(t * 0.1f));
+		al::Listener::position(listenerPos);
+		al::Listener::orientation(forward, glm::vec3(0, 1, 0));
+
+		for(unsigned i = 0; i < numEmitters; i++) {
+			Emitter const& e = emitters[i];
+			float a = e.phase + e.speed * t;
+			glm::vec3 offset(std::cos(a), 0.f, std::sin(a));
+			glm::vec3 tangent(-std::sin(a), 0.f, std::cos(a));
+			sources[i].position(e.center + offset * e.radius);
+			sources[i].velocity(tangent * (e.radius * e.speed));
+		}
+
+		auto updated = Clock::now();
+		loopback.renderSamples(mixBuffer.data(), kTickFrames);
+		auto mixed = Clock::now();
+
+		updateCost.push_back(std::chrono::duration<double, std::milli>(updated - start).count());
+		mixCost.push_back(std::chrono::duration<double, std::milli>(mixed - updated).count());
+		callsPerTick.push_back(al::CallCount() - calls);
+	}
+
+	Percentiles update = Summarize(updateCost);
+	Percentiles mix    = Summarize(mixCost);
+
+	printf("emitters: %u, ticks: %u\n", numEmitters, numTicks);
+	printf("%-12s %9s %9s %9s %9s\n", "(ms)", "p50", "p90", "p99", "max");
+	printf("%-12s %9.3f %9.3f %9.3f %9.3f\n", "update", update.p50, update.p90, update.p99, update.max);
+	printf("%-12s %9.3f %9.3f %9.3f %9.3f\n", "mix",    mix.p50,    mix.p90,    mix.p99,    mix.max);
+	unsigned long long totalCalls = 0;
+	for(auto calls : callsPerTick) totalCalls += calls;
+	printf("AL calls per tick: %.1f\n", numTicks ? (double)totalCalls / numTicks : 0.0);
+}
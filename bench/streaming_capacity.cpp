@@ -0,0 +1,213 @@
+// Copyright (c) 2018-2020 Benno Straub, licensed under the MIT license. (A copy can be found in alpp/AL.hpp)
+
+// Streaming capacity benchmark
+//
+// Finds the largest number of concurrent streams a loopback context sustains without starvation.
+// The mixer renders in real-time sized periods on its own thread, while one or more refill threads
+// keep every stream's buffer queue topped up. A trial fails if any source runs dry (and stops) or
+// the mixer can't keep up with real time.
+//
+// Build: g++ -std=c++17 -O2 -I. bench/streaming_capacity.cpp alpp/AL.cpp -lopenal -pthread
+// Usage: streaming_capacity [seconds per trial = 2] [max refill threads = 4]
+
+#include <alpp/AL.hpp>
+
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr unsigned kFrequency     = 48000;
+constexpr unsigned kPeriodFrames  = 480; // 10ms mixer period
+constexpr unsigned kQueueDepth    = 3;   // Buffers per stream
+constexpr unsigned kMaxStreams    = 4096;
+
+struct FormatInfo {
+	const char* name;
+	al::Format  format;
+	unsigned    bytesPerFrame;
+};
+
+const FormatInfo kFormats[] = {
+	{ "Mono16",    al::Format::Mono16,    2 },
+	{ "Stereo16",  al::Format::Stereo16,  4 },
+	{ "MonoF32",   al::Format::MonoF32,   4 },
+	{ "StereoF32", al::Format::StereoF32, 8 },
+};
+
+const unsigned kChunkFrames[] = { 1024, 4096, 16384 };
+
+// One chunk of a 440Hz tone in the requested format, reused for every upload
+std::vector<uint8_t> MakeChunk(FormatInfo const& fmt, unsigned frames) {
+	al::Format mono;
+	unsigned   channels;
+	al::DecomposeFormat(fmt.format, &mono, &channels);
+
+	std::vector<uint8_t> result(frames * fmt.bytesPerFrame);
+	for(unsigned i = 0; i < frames; i++) {
+		float v = 0.25f * std::sin(2.f * 3.14159265f * 440.f * i / kFrequency);
+		for(unsigned c = 0; c < channels; c++) {
+			size_t sample = i * channels + c;
+			if(mono == al::Format::MonoF32)
+				reinterpret_cast<float*>(result.data())[sample] = v;
+			else
+				reinterpret_cast<int16_t*>(result.data())[sample] = (int16_t)(v * 32767);
+		}
+	}
+	return result;
+}
+
+struct Stream {
+	al::Source source;
+	al::Buffer buffers[kQueueDepth];
+};
+
+struct TrialResult {
+	unsigned underruns     = 0; //<! Sources that ran out of queued data
+	unsigned mixerOverruns = 0; //<! Periods the mixer couldn't render in real time
+};
+
+TrialResult RunTrial(al::DeviceView device, FormatInfo const& fmt, unsigned chunkFrames, unsigned numStreams, unsigned numThreads, std::chrono::milliseconds duration) {
+	std::vector<uint8_t> chunk = MakeChunk(fmt, chunkFrames);
+
+	std::vector<Stream> streams(numStreams);
+	for(auto& stream : streams) {
+		stream.source.gen();
+		for(auto& buffer : stream.buffers) {
+			buffer.gen();
+			buffer.data(chunk.data(), chunk.size(), fmt.format, kFrequency);
+			stream.source.queueBuffer(buffer);
+		}
+	}
+	for(auto& stream : streams)
+		stream.source.play();
+
+	std::atomic<bool>     running   = true;
+	std::atomic<unsigned> underruns = 0;
+
+	std::vector<std::thread> refillThreads;
+	for(unsigned t = 0; t < numThreads; t++) {
+		refillThreads.emplace_back([&, t]() {
+			while(running.load(std::memory_order_relaxed)) {
+				for(size_t i = t; i < streams.size(); i += numThreads) {
+					al::SourceView source = streams[i].source;
+					for(unsigned n = source.buffers_processed(); n > 0; n--) {
+						al::BufferView buffer = source.unqueueBuffer();
+						buffer.data(chunk.data(), chunk.size(), fmt.format, kFrequency);
+						source.queueBuffer(buffer);
+					}
+					if(source.stopped()) { // Ran dry before we got to it
+						underruns++;
+						source.play();
+					}
+				}
+				std::this_thread::sleep_for(1ms);
+			}
+		});
+	}
+
+	// Mix on this thread, paced to real time
+	TrialResult result;
+	std::vector<float> mixBuffer(kPeriodFrames * 2);
+	auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(double(kPeriodFrames) / kFrequency));
+	auto start  = Clock::now();
+	auto next   = start;
+	while(Clock::now() - start < duration) {
+		device.renderSamples(mixBuffer.data(), kPeriodFrames);
+		next += period;
+		if(Clock::now() > next + period) {
+			result.mixerOverruns++;
+			next = Clock::now();
+		}
+		std::this_thread::sleep_until(next);
+	}
+
+	running = false;
+	for(auto& thread : refillThreads)
+		thread.join();
+
+	result.underruns = underruns;
+	for(auto& stream : streams) {
+		stream.source.stop();
+		stream.source.buffer(nullptr);
+	}
+	return result;
+}
+
+bool Sustains(al::DeviceView device, FormatInfo const& fmt, unsigned chunkFrames, unsigned numStreams, unsigned numThreads, std::chrono::milliseconds duration) {
+	TrialResult r = RunTrial(device, fmt, chunkFrames, numStreams, numThreads, duration);
+	return r.underruns == 0 && r.mixerOverruns == 0;
+}
+
+// Doubles the stream count until a trial fails, then bisects between the last good and the first bad count
+unsigned FindCapacity(al::DeviceView device, FormatInfo const& fmt, unsigned chunkFrames, unsigned numThreads, std::chrono::milliseconds duration) {
+	unsigned good = 0, bad = kMaxStreams + 1;
+	for(unsigned k = 1; k <= kMaxStreams; k *= 2) {
+		if(!Sustains(device, fmt, chunkFrames, k, numThreads, duration)) {
+			bad = k;
+			break;
+		}
+		good = k;
+	}
+	if(bad > kMaxStreams) bad = kMaxStreams + 1;
+	while(bad - good > 1) {
+		unsigned k = good + (bad - good) / 2;
+		if(Sustains(device, fmt, chunkFrames, k, numThreads, duration))
+			good = k;
+		else
+			bad = k;
+	}
+	return good;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	auto     duration   = std::chrono::milliseconds((long)(1000 * (argc > 1 ? atof(argv[1]) : 2.0)));
+	unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : 4;
+
+	al::Device device = al::Device::OpenLoopback();
+	if(!device) {
+		fprintf(stderr, "Failed to open loopback device (ALC_SOFT_loopback missing?)\n");
+		return 1;
+	}
+	if(!device.isRenderFormatSupported(kFrequency, ALC_STEREO_SOFT, ALC_FLOAT_SOFT)) {
+		fprintf(stderr, "Loopback device doesn't support %u Hz stereo float rendering\n", kFrequency);
+		return 1;
+	}
+
+	al::Context::Options options;
+	options.add({
+		ALC_FREQUENCY,           (int)kFrequency,
+		ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+		ALC_FORMAT_TYPE_SOFT,     ALC_FLOAT_SOFT,
+		ALC_MONO_SOURCES,         (int)kMaxStreams,
+		ALC_STEREO_SOURCES,       (int)kMaxStreams,
+	});
+	options.device = std::move(device);
+	al::Context context { std::move(options) };
+	al::DeviceView loopback = context.device();
+
+	printf("%-10s %8s %8s %12s\n", "format", "chunk", "threads", "max streams");
+	for(auto& fmt : kFormats) {
+		for(unsigned chunkFrames : kChunkFrames) {
+			for(unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+				unsigned capacity = FindCapacity(loopback, fmt, chunkFrames, threads, duration);
+				printf("%-10s %8u %8u %12u\n", fmt.name, chunkFrames, threads, capacity);
+				fflush(stdout);
+			}
+		}
+	}
+}